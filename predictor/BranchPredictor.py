@@ -91,6 +91,13 @@ class NeuroBP(BranchPredictor):
 
     globalPredictorSize = Param.Unsigned(8192, "Size of global predictor")
     globalCtrBits = Param.Unsigned(2, "Bits per counter")    
+    weightBits = Param.Unsigned(8,
+        "Bits per saturating perceptron weight (2-16)")
+    perceptronCount = Param.Unsigned(20, "Number of perceptrons")
+    adaptiveTheta = Param.Bool(False,
+        "Adapt the training threshold to the misprediction rate")
+    thetaPerPerceptron = Param.Bool(False,
+        "One adaptive training threshold per perceptron")
 
     
 class NeuroPathBP(BranchPredictor):
@@ -100,3 +107,45 @@ class NeuroPathBP(BranchPredictor):
 
     globalPredictorSize = Param.Unsigned(8192, "Size of global predictor")
     globalCtrBits = Param.Unsigned(2, "Bits per counter")    
+    weightBits = Param.Unsigned(8,
+        "Bits per saturating perceptron weight (2-16)")
+    perceptronCount = Param.Unsigned(10, "Number of perceptrons")
+    adaptiveTheta = Param.Bool(False,
+        "Adapt the training threshold to the misprediction rate")
+    thetaPerPerceptron = Param.Bool(False,
+        "One adaptive training threshold per perceptron")
+
+class PiecewiseLinearBP(NeuroPathBP):
+    type = 'PiecewiseLinearBP'
+    cxx_class = 'PiecewiseLinearBP'
+    cxx_header = "cpu/pred/piecewise.hh"
+
+    globalPredictorSize = 64
+    perceptronCount = 64
+    pcCount = Param.Unsigned(8,
+        "Number of weight sets, chosen by the address of the predicted branch")
+
+class HashedPerceptronBP(BranchPredictor):
+    type = 'HashedPerceptronBP'
+    cxx_class = 'HashedPerceptronBP'
+    cxx_header = "cpu/pred/hashed_perceptron.hh"
+
+    globalPredictorSize = Param.Unsigned(256,
+        "Global history length hashed into the tables")
+    numTables = Param.Unsigned(8, "Number of weight tables (2-16)")
+    tableSize = Param.Unsigned(1024, "Weights per table")
+    weightBits = Param.Unsigned(8,
+        "Bits per saturating perceptron weight (2-16)")
+    adaptiveTheta = Param.Bool(False,
+        "Adapt the training threshold to the misprediction rate")
+    thetaPerPerceptron = Param.Bool(False,
+        "One adaptive training threshold per address-indexed weight")
+
+class CaptureBP(BranchPredictor):
+    type = 'CaptureBP'
+    cxx_class = 'CaptureBP'
+    cxx_header = "cpu/pred/capture.hh"
+
+    predictor = Param.BranchPredictor("Predictor whose calls are captured")
+    captureFile = Param.String("bpcalls.bin",
+        "File the predictor calls are written to (see replay/README.md)")
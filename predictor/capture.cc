@@ -0,0 +1,161 @@
+/*****************************************************************
+ * File: capture.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Predictor wrapper recording every call the CPU makes
+ * to another predictor into a compact binary file, so that a gem5 run
+ * can be played back offline through any predictor.
+ ****************************************************************/
+
+#include "cpu/pred/capture.hh"
+
+#include <cstring>
+
+#include "base/callback.hh"
+#include "base/misc.hh"
+#include "sim/core.hh"
+
+const char captureMagic[8] = { 'N', 'P', 'B', 'P', 'C', 'A', 'L', 'L' };
+
+CaptureBP::CaptureBP(const CaptureBPParams *params)
+  : BPredUnit(params),
+    predictor(params->predictor),
+    filename(params->captureFile),
+    file(std::fopen(params->captureFile.c_str(), "wb")),
+    historyPool(params->numThreads)
+{
+  if (!predictor) {
+    fatal("CaptureBP needs a predictor to capture!\n");
+  }
+  if (!file) {
+    fatal("Could not create capture %s\n", filename.c_str());
+  }
+
+  std::memcpy(header.magic, captureMagic, sizeof(header.magic));
+  header.version      = captureVersion;
+  header.recordSize   = sizeof(PackedCall);
+  header.calls        = 0;
+  header.histories    = 0;
+  header.instructions = 0;
+
+  // placeholder, rewritten with the final counts on close
+  if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+    fatal("Could not write to capture %s\n", filename.c_str());
+  }
+  buffer.reserve(4096);
+
+  // gem5 does not delete its SimObjects on exit
+  registerExitCallback(
+    new MakeCallback<CaptureBP, &CaptureBP::close>(this, true));
+}
+
+CaptureBP::~CaptureBP()
+{
+  close();
+}
+
+CaptureBP::CapturedHistory *
+CaptureBP::newHistory(ThreadID tid)
+{
+  CapturedHistory *history = historyPool.allocate(tid);
+  history->branch  = header.histories++;
+  history->history = NULL;
+  return history;
+}
+
+void
+CaptureBP::record(CapturedCallKind kind, ThreadID tid, Addr pc, bool flag,
+                  const CapturedHistory *history)
+{
+  if (!file) return;
+  buffer.push_back(packCall(kind, tid, pc, flag, history->branch));
+  header.calls++;
+  if (buffer.size() == buffer.capacity()) flush();
+}
+
+bool
+CaptureBP::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
+{
+  CapturedHistory *history = newHistory(tid);
+  const bool taken = predictor->lookup(tid, branch_addr, history->history);
+  bp_history = history;
+  record(CallLookup, tid, branch_addr, taken, history);
+  return taken;
+}
+
+void
+CaptureBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
+{
+  CapturedHistory *history = newHistory(tid);
+  predictor->uncondBranch(tid, pc, history->history);
+  bp_history = history;
+  record(CallUncondBranch, tid, pc, true, history);
+}
+
+void
+CaptureBP::btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history)
+{
+  CapturedHistory *history = static_cast<CapturedHistory *>(bp_history);
+  predictor->btbUpdate(tid, branch_addr, history->history);
+  record(CallBTBUpdate, tid, branch_addr, false, history);
+}
+
+void
+CaptureBP::update(ThreadID tid, Addr branch_addr, bool taken,
+                  void *bp_history, bool squashed)
+{
+  CapturedHistory *history = static_cast<CapturedHistory *>(bp_history);
+  predictor->update(tid, branch_addr, taken, history->history, squashed);
+  record(squashed ? CallSquashedUpdate : CallUpdate, tid, branch_addr, taken,
+         history);
+
+  // a squashing update keeps the history for the commit that follows
+  if (!squashed) historyPool.release(tid, history);
+}
+
+void
+CaptureBP::squash(ThreadID tid, void *bp_history)
+{
+  CapturedHistory *history = static_cast<CapturedHistory *>(bp_history);
+  predictor->squash(tid, history->history);
+  record(CallSquash, tid, 0, false, history);
+  historyPool.release(tid, history);
+}
+
+unsigned
+CaptureBP::getGHR(ThreadID tid, void *bp_history) const
+{
+  const CapturedHistory *history =
+    static_cast<const CapturedHistory *>(bp_history);
+  return predictor->getGHR(tid, history ? history->history : NULL);
+}
+
+void
+CaptureBP::flush()
+{
+  if (buffer.empty()) return;
+  if (std::fwrite(buffer.data(), sizeof(PackedCall), buffer.size(), file)
+      != buffer.size()) {
+    fatal("Could not write to capture %s\n", filename.c_str());
+  }
+  buffer.clear();
+}
+
+void
+CaptureBP::close()
+{
+  if (!file) return;
+  flush();
+  if (std::fseek(file, 0, SEEK_SET) != 0 ||
+      std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+      std::fclose(file) != 0) {
+    fatal("Could not finalize capture %s\n", filename.c_str());
+  }
+  file = NULL;
+}
+
+CaptureBP*
+CaptureBPParams::create()
+{
+  return new CaptureBP(this);
+}
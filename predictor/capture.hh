@@ -0,0 +1,182 @@
+/*****************************************************************
+ * File: capture.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Predictor wrapper recording every call the CPU makes
+ * to another predictor into a compact binary file, so that a gem5 run
+ * can be played back offline through any predictor: header file.
+ ****************************************************************/
+
+#ifndef __CPU_PRED_CAPTURE_PRED_HH__
+#define __CPU_PRED_CAPTURE_PRED_HH__
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "params/CaptureBP.hh"
+
+/** Predictor calls recorded in a capture */
+enum CapturedCallKind
+{
+  CallLookup         = 0, // lookup, flag = predicted taken
+  CallUncondBranch   = 1, // uncondBranch
+  CallBTBUpdate      = 2, // btbUpdate
+  CallUpdate         = 3, // update committing the branch, flag = taken
+  CallSquashedUpdate = 4, // update correcting the branch, flag = taken
+  CallSquash         = 5  // squash
+};
+
+/**
+ * On-disk layout of a predictor call: two little-endian 64-bit words,
+ * 16 bytes per call.
+ *   info:    bits  0-47 pc (sign-extended on decode)
+ *            bits 48-50 call kind
+ *            bit  51    flag (prediction of a lookup, outcome of an
+ *                       update)
+ *            bits 56-63 thread
+ *   history: branch the call is about, numbered by the lookup or
+ *            uncondBranch that created its history, from 0
+ */
+struct PackedCall
+{
+  uint64_t info;
+  uint64_t history;
+};
+
+/**
+ * Header at the start of a capture. The counts are filled in once the
+ * whole capture has been written; instructions is 0 when the capture
+ * does not know them (the BPredUnit of gem5 only sees branches).
+ */
+struct CaptureHeader
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  uint64_t calls;
+  uint64_t histories;
+  uint64_t instructions;
+};
+
+/** Magic string opening every capture */
+extern const char captureMagic[8];
+
+/** Current version of the capture format */
+const uint32_t captureVersion = 1;
+
+/** Packs a predictor call into its on-disk layout. */
+inline PackedCall
+packCall(CapturedCallKind kind, ThreadID tid, Addr pc, bool flag,
+         uint64_t history)
+{
+  const uint64_t addrMask = (ULL(1) << 48) - 1;
+
+  PackedCall packed;
+  packed.info    = (pc & addrMask) | ((uint64_t)kind << 48) |
+                   ((uint64_t)flag << 51) | ((uint64_t)(tid & 0xff) << 56);
+  packed.history = history;
+  return packed;
+}
+
+/** Call kind of a packed call */
+inline CapturedCallKind
+callKind(const PackedCall &packed)
+{
+  return (CapturedCallKind)((packed.info >> 48) & 7);
+}
+
+/** Address of the branch of a packed call */
+inline Addr
+callPC(const PackedCall &packed)
+{
+  return (Addr)((int64_t)(packed.info << 16) >> 16);
+}
+
+/** Flag (prediction or outcome) of a packed call */
+inline bool
+callFlag(const PackedCall &packed)
+{
+  return (packed.info >> 51) & 1;
+}
+
+/** Thread of a packed call */
+inline ThreadID
+callThread(const PackedCall &packed)
+{
+  return (ThreadID)(packed.info >> 56);
+}
+
+/**
+ * Passes every call on to the wrapped predictor, which makes the
+ * predictions, and appends it to the capture file. The bp_history
+ * handed to the CPU is a record of the wrapper holding the number of
+ * the branch along with the history of the wrapped predictor, so that
+ * later calls can be tied to the lookup they follow up on whatever
+ * the wrapped predictor keeps (possibly nothing, as AlwaysBP).
+ *
+ * The capture is written out when gem5 exits (or the wrapper is
+ * deleted).
+ */
+class CaptureBP : public BPredUnit
+{
+public:
+  CaptureBP(const CaptureBPParams *params);
+
+  ~CaptureBP();
+
+  bool lookup(ThreadID tid, Addr branch_addr, void * &bp_history);
+
+  void uncondBranch(ThreadID tid, Addr pc, void * &bp_history);
+
+  void btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history);
+
+  void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
+              bool squashed);
+
+  void squash(ThreadID tid, void *bp_history);
+
+  unsigned getGHR(ThreadID tid, void *bp_history) const;
+
+  /**
+   * Counts the instructions run since the previous branch, for the
+   * callers that know them (the replay tool; the CPU does not).
+   */
+  void addInstructions(uint64_t count) { header.instructions += count; }
+
+  /** Writes out the buffered calls and the final header. */
+  void close();
+
+private:
+  /** History handed to the CPU in place of the wrapped predictor's */
+  struct CapturedHistory
+  {
+    uint64_t branch;
+    void *history;
+  };
+
+  /** Creates the history of a new branch */
+  CapturedHistory *newHistory(ThreadID tid);
+
+  /** Appends a call to the capture */
+  void record(CapturedCallKind kind, ThreadID tid, Addr pc, bool flag,
+              const CapturedHistory *history);
+
+  /** Writes out the buffered calls */
+  void flush();
+
+  /** The predictor the calls are passed on to */
+  BPredUnit *predictor;
+
+  std::string filename;
+  FILE *file;
+  CaptureHeader header;
+  std::vector<PackedCall> buffer;
+
+  HistoryPool<CapturedHistory> historyPool;
+};
+
+#endif
@@ -0,0 +1,255 @@
+/*****************************************************************
+ * File: hashed_perceptron.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hashed perceptron branch predictor, summing one
+ * weight out of each of several small tables indexed by hashes of
+ * the branch address and segments of the global history.
+ ****************************************************************/
+
+#include "cpu/pred/hashed_perceptron.hh"
+
+#include <algorithm>
+#include "base/intmath.hh"
+
+HashedPerceptronBP::HashedPerceptronBP(
+    const HashedPerceptronBPParams *params)
+  : BPredUnit(params),
+    historyPool(params->numThreads),
+    globalPredictorSize(params->globalPredictorSize),
+    numTables(params->numTables),
+    tableSize(params->tableSize),
+    indexBits(floorLog2(params->tableSize)),
+    indexMask(params->tableSize - 1),
+    segmentEnd(params->numTables, 0),
+    foldOut(params->numTables, 0),
+    globalHistory(params->numThreads),
+    globalHistoryWords(params->numThreads *
+                       HistoryRegister::storageWords(
+                         params->globalPredictorSize), 0),
+    foldedHistory(params->numThreads * params->numTables, 0),
+    trained(0)
+{
+  if (!isPowerOf2(globalPredictorSize)) {
+    fatal("Invalid global predictor size!\n");
+  }
+
+  if (!isPowerOf2(tableSize) || tableSize < 2) {
+    fatal("Invalid table size!\n");
+  }
+
+  if (numTables < 2 || numTables > maxTables) {
+    fatal("Invalid number of tables, must be between 2 and %u!\n",
+          maxTables);
+  }
+
+  if (globalPredictorSize < numTables - 1) {
+    fatal("Global predictor too small for the number of tables!\n");
+  }
+
+  // table 0 sees no history; the segments of the others double in
+  // length towards the oldest outcome, the last one ending at
+  // globalPredictorSize, e.g. [0,4) [4,8) ... [64,128) [128,256)
+  for (unsigned t = 1; t < numTables; t++) {
+    segmentEnd[t] = std::max(globalPredictorSize >> (numTables - 1 - t),
+                             segmentEnd[t - 1] + 1);
+    foldOut[t]    = segmentEnd[t] % indexBits;
+  }
+
+  // Set up the history registers, each over its own part of the
+  // storage
+  const unsigned words = HistoryRegister::storageWords(globalPredictorSize);
+  for (ThreadID tid = 0; tid < (ThreadID)numThreads; tid++) {
+    globalHistory[tid].attach(&globalHistoryWords[tid * words],
+                              globalPredictorSize);
+  }
+
+  theta.init(2.14 * numTables + 20.58, tableSize, params->adaptiveTheta,
+             params->thetaPerPerceptron);
+
+  weightsTable.assign(numTables, tableSize, params->weightBits);
+}
+
+void
+HashedPerceptronBP::pushHistory(ThreadID tid, bool taken)
+{
+  HistoryRegister &history = globalHistory[tid];
+  unsigned *folds = &foldedHistory[tid * numTables];
+
+  // every fold rotates by one position with the new outcome coming in
+  // at position 0, and the outcome about to leave its window (the one
+  // segmentEnd - 1 branches ago) cancelled out at its position
+  for (unsigned t = 1; t < numTables; t++) {
+    unsigned fold = (folds[t] << 1) | taken;
+    fold ^= (unsigned)history[segmentEnd[t] - 1] << foldOut[t];
+    folds[t] = (fold ^ (fold >> indexBits)) & indexMask;
+  }
+  history.push(taken);
+}
+
+void
+HashedPerceptronBP::computeIndices(Addr branch_addr, const unsigned *folds,
+                                   unsigned *indices) const
+{
+  const uint64_t pc = branch_addr >> instShiftAmt;
+  indices[0] = (pc * 0xff51afd7ed558ccdULL) >> (64 - indexBits);
+  for (unsigned t = 1; t < numTables; t++) {
+    // the outcomes of segment t, i.e. the history up to its end
+    // without the history up to its start
+    uint64_t segment = folds[t] ^ folds[t - 1];
+
+    // multiplicative hash of the address, the segment and the table,
+    // keeping the high bits of the product which mix in every input bit
+    uint64_t key = (pc ^ (segment << 32)) + t * 0x9e3779b97f4a7c15ULL;
+    indices[t] = (key * 0xff51afd7ed558ccdULL) >> (64 - indexBits);
+  }
+}
+
+void
+HashedPerceptronBP::restoreHistory(ThreadID tid, const BPHistory *history)
+{
+  globalHistory[tid].restore(history->globalHistory);
+  std::copy(history->folds, history->folds + numTables,
+            &foldedHistory[tid * numTables]);
+}
+
+template <class W>
+int
+HashedPerceptronBP::sumWeights(const unsigned *indices) const
+{
+  int sum = 0;
+  for (unsigned t = 0; t < numTables; t++) {
+    sum += weightsTable.row<W>(t)[indices[t]];
+  }
+  return sum;
+}
+
+template <class W>
+void
+HashedPerceptronBP::trainWeights(const unsigned *indices, bool taken)
+{
+  for (unsigned t = 0; t < numTables; t++) {
+    W &weight = weightsTable.row<W>(t)[indices[t]];
+    weight = weightsTable.saturate(weight, taken);
+  }
+}
+
+void
+HashedPerceptronBP::btbUpdate(ThreadID tid, Addr branch_addr,
+                              void * &bp_history)
+{
+  //Update Global History to Not Taken (clear LSB), the most recent
+  //outcome being bit 0 of every fold
+  if (globalHistory[tid][0]) {
+    globalHistory[tid].set(0, false);
+    unsigned *folds = &foldedHistory[tid * numTables];
+    for (unsigned t = 1; t < numTables; t++) folds[t] ^= 1;
+  }
+}
+
+bool
+HashedPerceptronBP::lookup(ThreadID tid, Addr branch_addr,
+                           void * &bp_history)
+{
+  const unsigned *folds = &foldedHistory[tid * numTables];
+  BPHistory *history = historyPool.allocate(tid);
+  history->globalHistory = globalHistory[tid].checkpoint();
+  std::copy(folds, folds + numTables, history->folds);
+
+  // one weight per table, selected by the address and history segment
+  computeIndices(branch_addr, folds, history->indices);
+  int y_out = weightsTable.wide() ? sumWeights<int16_t>(history->indices)
+                                  : sumWeights<int8_t>(history->indices);
+  bool prediction = (y_out >= 0);
+
+  // The output and the selected weights are kept so that update
+  // trains exactly what was used for the prediction.
+  history->globalPredTaken = prediction;
+  history->globalUsed      = true;
+  history->yOut            = y_out;
+  bp_history = (void *)history;
+
+  // Speculatively update the global history with the prediction
+  pushHistory(tid, prediction);
+  return prediction;
+}
+
+void
+HashedPerceptronBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
+{
+  BPHistory *history       = historyPool.allocate(tid);
+  history->globalHistory   = globalHistory[tid].checkpoint();
+  history->globalPredTaken = true;
+  history->globalUsed      = false;
+  history->yOut            = 0;
+  std::copy(&foldedHistory[tid * numTables],
+            &foldedHistory[tid * numTables] + numTables, history->folds);
+  bp_history = static_cast<void *>(history);
+  pushHistory(tid, true);
+}
+
+void
+HashedPerceptronBP::update(ThreadID tid, Addr branch_addr, bool taken,
+                           void *bp_history, bool squashed)
+{
+  assert(bp_history);
+  BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+  // If this is a misprediction, restore the speculatively updated
+  // global history and shift in the actual outcome instead. Training
+  // is left to the update done when the branch commits.
+  if (squashed) {
+    restoreHistory(tid, history);
+    pushHistory(tid, taken);
+    return;
+  }
+
+  // Train only on a misprediction or when the output was not
+  // confidently beyond the threshold, which adapts to how often each
+  // happens
+  const unsigned row = history->indices[0];
+  bool train = false;
+  if (history->globalUsed) {
+    if (history->globalPredTaken != taken) {
+      theta.mispredicted(row);
+      train = true;
+    } else if ((unsigned)abs(history->yOut) <= theta[row]) {
+      theta.weaklyCorrect(row);
+      train = true;
+    }
+  }
+
+  if (train) {
+    trained++;
+    if (weightsTable.wide()) trainWeights<int16_t>(history->indices, taken);
+    else                     trainWeights<int8_t>(history->indices, taken);
+  }
+
+  // The branch has committed, so its BPHistory is no longer needed
+  historyPool.release(tid, history);
+}
+
+void
+HashedPerceptronBP::squash(ThreadID tid, void *bp_history)
+{
+  BPHistory *history = static_cast<BPHistory *>(bp_history);
+
+  // Restore global history to state prior to this branch.
+  restoreHistory(tid, history);
+
+  // Return this BPHistory to the pool now that we're done with it.
+  historyPool.release(tid, history);
+}
+
+unsigned
+HashedPerceptronBP::getGHR(ThreadID tid, void *bp_history) const
+{
+  return globalHistory[tid].low(
+    static_cast<BPHistory *>(bp_history)->globalHistory);
+}
+
+HashedPerceptronBP*
+HashedPerceptronBPParams::create()
+{
+  return new HashedPerceptronBP(this);
+}
@@ -0,0 +1,204 @@
+/*****************************************************************
+ * File: hashed_perceptron.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hashed perceptron branch predictor, summing one
+ * weight out of each of several small tables indexed by hashes of
+ * the branch address and segments of the global history: header
+ * file.
+ ****************************************************************/
+
+#ifndef __CPU_PRED_HASHED_PERCEPTRON_PRED_HH__
+#define __CPU_PRED_HASHED_PERCEPTRON_PRED_HH__
+
+#include <vector>
+#include <stdlib.h>
+
+#include "base/types.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/history_register.hh"
+#include "cpu/pred/perceptron_weights.hh"
+#include "cpu/pred/training_threshold.hh"
+#include "params/HashedPerceptronBP.hh"
+
+/**
+ * Hashed perceptron predictor. Table 0 is indexed by the branch
+ * address alone and acts as the bias; table t > 0 is indexed by the
+ * address hashed with the outcomes of the branches [start, end) ago,
+ * the segments doubling in length up to globalPredictorSize, so that
+ * recent history is finely resolved and old history is still seen. The
+ * output is the sum of the numTables selected weights and every
+ * selected weight is trained towards the outcome.
+ *
+ * Segments are hashed through folded histories: the history up to the
+ * end of each segment folded (xored) down to the index width, which is
+ * kept up to date in O(1) per branch, the fold of a segment being the
+ * xor of the folds up to its end and up to its start. A prediction thus
+ * costs numTables hashes and table reads however long the history is.
+ */
+class HashedPerceptronBP : public BPredUnit
+{
+public:
+  /**
+   * Default branch predictor constructor.
+   */
+  HashedPerceptronBP(const HashedPerceptronBPParams *params);
+
+  /**
+   * Looks up the given address in the branch predictor and returns
+   * a true/false value as to whether it is taken.  Also creates a
+   * BPHistory object to store any state it will need on squash/update.
+   * @param branch_addr The address of the branch to look up.
+   * @param bp_history Pointer that will be set to the BPHistory object.
+   * @return Whether or not the branch is taken.
+   */
+  bool lookup(ThreadID tid, Addr branch_addr, void * &bp_history);
+
+  /**
+   * Records that there was an unconditional branch, and modifies
+   * the bp history to point to an object that has the previous
+   * global history stored in it.
+   * @param bp_history Pointer that will be set to the BPHistory object.
+   */
+  void uncondBranch(ThreadID tid, Addr pc, void * &bp_history);
+
+  /**
+   * Updates the branch predictor to Not Taken if a BTB entry is
+   * invalid or not found.
+   * @param branch_addr The address of the branch to look up.
+   * @param bp_history Pointer to any bp history state.
+   */
+  void btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history);
+
+  /**
+   * Updates the branch predictor with the actual result of a branch.
+   * @param branch_addr The address of the branch to update.
+   * @param taken Whether or not the branch was taken.
+   * @param bp_history Pointer to the BPHistory object that was created
+   * when the branch was predicted.
+   * @param squashed is set when this function is called during a squash
+   * operation.
+   */
+  void update(ThreadID tid, Addr branch_addr, bool taken, void *bp_history,
+              bool squashed);
+
+  /**
+   * Restores the global branch history on a squash.
+   * @param bp_history Pointer to the BPHistory object that has the
+   * previous global branch history in it.
+   */
+  void squash(ThreadID tid, void *bp_history);
+
+  unsigned getGHR(ThreadID tid, void *bp_history) const;
+
+  /** Number of times the perceptron weights were trained so far */
+  uint64_t trainedBranches() const { return trained; }
+
+  /** Largest supported numTables */
+  static const unsigned maxTables = 16;
+
+private:
+  /**
+   * Shifts an outcome into the global history of a thread and its
+   * folded histories.
+   * @param tid Thread the branch belongs to.
+   * @param taken Outcome of the branch.
+   */
+  void pushHistory(ThreadID tid, bool taken);
+
+  /**
+   * Computes the weight index of every table for a branch.
+   * @param branch_addr Address of the branch.
+   * @param folds Folded histories of the thread of the branch.
+   * @param indices numTables indices, one per table.
+   */
+  void computeIndices(Addr branch_addr, const unsigned *folds,
+                      unsigned *indices) const;
+
+  struct BPHistory;
+
+  /**
+   * Rolls the global history of a thread and its folded histories back
+   * to their state prior to a branch.
+   */
+  void restoreHistory(ThreadID tid, const BPHistory *history);
+
+  /** Sums the selected weights, W being the weight storage type */
+  template <class W>
+  int sumWeights(const unsigned *indices) const;
+
+  /** Trains the selected weights towards the outcome */
+  template <class W>
+  void trainWeights(const unsigned *indices, bool taken);
+
+  /**
+   * The branch history information that is created upon predicting
+   * a branch.  It will be passed back upon updating and squashing,
+   * when the BP can use this information to update/restore its
+   * state properly.
+   */
+  struct BPHistory {
+    /** Global history checkpoint at the time of the prediction */
+    HistoryRegister::Checkpoint globalHistory;
+    bool globalPredTaken;
+    /** Whether the tables were used, i.e. for conditional branches */
+    bool globalUsed;
+    /** Perceptron output the prediction was made from */
+    int yOut;
+    /** Weight selected in each table */
+    unsigned indices[maxTables];
+    /** Folded histories at the time of the prediction */
+    unsigned folds[maxTables];
+  };
+
+  /** Recycled BPHistory records, released on squash and commit */
+  HistoryPool<BPHistory> historyPool;
+
+  /** Number of global history outcomes hashed into the tables */
+  unsigned globalPredictorSize;
+
+  /** Number of weight tables, including the address-only one */
+  unsigned numTables;
+
+  /** Number of weights per table, a power of 2 */
+  unsigned tableSize;
+
+  /** log2(tableSize), i.e. the number of index bits */
+  unsigned indexBits;
+
+  /** Mask of the index bits */
+  unsigned indexMask;
+
+  /** End (exclusive) of the history segment of each table, the
+   *  segment of table t starting at the end of that of table t - 1 */
+  std::vector<unsigned> segmentEnd;
+
+  /** Position in a fold of the outcome leaving the history up to
+   *  segmentEnd, i.e. segmentEnd modulo indexBits */
+  std::vector<unsigned> foldOut;
+
+  /** Global history register of each thread */
+  std::vector<HistoryRegister> globalHistory;
+
+  /** Storage of the global history registers */
+  std::vector<uint64_t> globalHistoryWords;
+
+  /** Folded history up to segmentEnd of each table, numTables per
+   *  thread; table 0 has no history and its fold stays 0 */
+  std::vector<unsigned> foldedHistory;
+
+  /** Training threshold, empirically estimated in the fast neural
+   *  branch predictor paper to be 2.14 * inputs + 20.58, the inputs
+   *  being the tables here, or adapted from that starting point,
+   *  globally or per table 0 (address only) entry */
+  TrainingThreshold theta;
+
+  /** Training passes so far, see trainedBranches() */
+  uint64_t trained;
+
+  /** Weight tables, one row of tableSize weights per table */
+  PerceptronWeights weightsTable;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*****************************************************************
+ * File: history_pool.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Pool of the BPHistory records the predictors hand out
+ * on every prediction, so that no heap allocation is done on the
+ * prediction path.
+ ****************************************************************/
+
+#ifndef __CPU_PRED_HISTORY_POOL_HH__
+#define __CPU_PRED_HISTORY_POOL_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * Hands out records of a plain (trivially copyable) type from slabs
+ * kept on per-thread free lists. Records follow the bp_history lifetime
+ * of BPredUnit: one is allocated by lookup/uncondBranch and released
+ * either by squash (the branch was squashed away) or by the update of
+ * the committing branch (squashed == false); a squashing update keeps
+ * it alive for the commit that follows. A record must be released on
+ * the thread it was allocated on. Slabs are only freed with the pool,
+ * so memory stays at the high-water mark of branches in flight.
+ */
+template <class Record>
+class HistoryPool
+{
+public:
+  /**
+   * @param numThreads Number of hardware threads using the pool
+   */
+  HistoryPool(unsigned numThreads)
+    : freeLists(numThreads, NULL)
+  { }
+
+  ~HistoryPool()
+  {
+    for (size_t i = 0; i < slabs.size(); i++) delete [] slabs[i];
+  }
+
+  /**
+   * Takes a record off the free list of the given thread. The contents
+   * of the record are undefined.
+   */
+  Record *allocate(ThreadID tid)
+  {
+    if (!freeLists[tid]) refill(tid);
+    Slot *slot = freeLists[tid];
+    freeLists[tid] = slot->next;
+    return &slot->record;
+  }
+
+  /**
+   * Returns a record to the free list of the given thread.
+   */
+  void release(ThreadID tid, Record *record)
+  {
+    Slot *slot = reinterpret_cast<Slot *>(record);
+    slot->next = freeLists[tid];
+    freeLists[tid] = slot;
+  }
+
+private:
+  HistoryPool(const HistoryPool &);
+  HistoryPool &operator=(const HistoryPool &);
+
+  /** Storage of a record, reused as a free list link when free */
+  union Slot
+  {
+    Record record;
+    Slot *next;
+  };
+
+  /** Number of records allocated at once when a free list runs dry */
+  static const unsigned slabSize = 256;
+
+  /** Carves a new slab into the free list of the given thread */
+  void refill(ThreadID tid)
+  {
+    Slot *slab = new Slot[slabSize];
+    slabs.push_back(slab);
+    for (unsigned i = 0; i < slabSize - 1; i++) slab[i].next = &slab[i + 1];
+    slab[slabSize - 1].next = freeLists[tid];
+    freeLists[tid] = slab;
+  }
+
+  /** Free records of each thread */
+  std::vector<Slot *> freeLists;
+
+  /** Every slab allocated, for deletion with the pool */
+  std::vector<Slot *> slabs;
+};
+
+#endif
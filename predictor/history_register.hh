@@ -0,0 +1,140 @@
+/*****************************************************************
+ * File: history_register.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Global history register of any length, for the
+ * neural predictors whose history runs past 32 bits.
+ ****************************************************************/
+
+#ifndef __CPU_PRED_HISTORY_REGISTER_HH__
+#define __CPU_PRED_HISTORY_REGISTER_HH__
+
+#include <algorithm>
+#include <stdint.h>
+
+#include "base/intmath.hh"
+
+/**
+ * Most branches in flight past a checkpoint of a history, each having
+ * shifted in one outcome (or one path address) before the checkpoint is
+ * restored. Every branch in flight holds an entry of the reorder
+ * buffer, which the O3 CPU sizes at 192 by default.
+ */
+const unsigned maxBranchesInFlight = 256;
+
+/**
+ * Global history register holding the outcomes of at least length
+ * branches, the outcome of the branch age branches ago being bit age.
+ * The bits live in a ring of uint64_t words provided by the owner and
+ * written backwards from head, so that shifting in an outcome is O(1)
+ * and the whole register is checkpointed by its head alone. The ring
+ * holds the length plus maxBranchesInFlight outcomes (rounded up to a
+ * power of two), so that the outcomes shifted in by the branches in
+ * flight after a checkpoint do not overwrite its history before it is
+ * restored.
+ *
+ * The register has no constructor, so that it can live in zeroed
+ * memory, and is unusable until attach() is called.
+ */
+class HistoryRegister
+{
+public:
+  /** Position of the most recent outcome, which restore() goes back to */
+  typedef unsigned Checkpoint;
+
+  /** Number of words of storage needed for length bits of history */
+  static unsigned storageWords(unsigned length)
+  {
+    return std::max(1u << ceilLog2(length + maxBranchesInFlight), 64u) / 64;
+  }
+
+  /**
+   * Sets up the register over zeroed storage, i.e. a history of not
+   * taken branches.
+   * @param storage storageWords(length) words, owned by the caller
+   * @param length Number of outcomes the register has to keep
+   */
+  void attach(uint64_t *storage, unsigned length)
+  {
+    words = storage;
+    head  = 0;
+    mask  = storageWords(length) * 64 - 1;
+  }
+
+  /** Shifts in the outcome of a branch */
+  void push(bool taken)
+  {
+    head = (head - 1) & mask;
+    uint64_t bit = (uint64_t)1 << (head & 63);
+    if (taken) words[head >> 6] |= bit;
+    else       words[head >> 6] &= ~bit;
+  }
+
+  /** Outcome of the branch age branches ago */
+  bool operator[](unsigned age) const
+  {
+    unsigned pos = (head + age) & mask;
+    return (words[pos >> 6] >> (pos & 63)) & 1;
+  }
+
+  /** Overwrites the outcome of the branch age branches ago */
+  void set(unsigned age, bool taken)
+  {
+    unsigned pos = (head + age) & mask;
+    uint64_t bit = (uint64_t)1 << (pos & 63);
+    if (taken) words[pos >> 6] |= bit;
+    else       words[pos >> 6] &= ~bit;
+  }
+
+  Checkpoint checkpoint() const { return head; }
+
+  /** Rolls the register back to the given checkpoint */
+  void restore(Checkpoint at) { head = at; }
+
+  /**
+   * Copies the n most recent outcomes as of a checkpoint into out, as
+   * the history bits read by the perceptron kernels (bit i of the
+   * copy being the outcome i branches before the checkpoint).
+   * @param at Checkpoint the outcomes are read from
+   * @param out (n + 63) / 64 words; bits past n are undefined
+   * @param n Number of outcomes to copy
+   */
+  void read(Checkpoint at, uint64_t *out, unsigned n) const
+  {
+    const unsigned word_mask = mask >> 6;
+    const unsigned shift     = at & 63;
+    unsigned word            = at >> 6;
+    for (unsigned w = 0; w < (n + 63) / 64; w++) {
+      uint64_t lo = words[word];
+      word = (word + 1) & word_mask;
+      out[w] = shift ? (lo >> shift) | (words[word] << (64 - shift)) : lo;
+    }
+  }
+
+  /** The 32 most recent outcomes as of a checkpoint, for getGHR */
+  unsigned low(Checkpoint at) const
+  {
+    uint64_t bits;
+    read(at, &bits, 32);
+    return (unsigned)bits;
+  }
+
+  /** Makes this register a copy of other, of the same length */
+  void copyFrom(const HistoryRegister &other)
+  {
+    std::copy(other.words, other.words + (mask >> 6) + 1, words);
+    head = other.head;
+  }
+
+private:
+  /** Ring of history bits, bit p being bit (p % 64) of word p / 64 */
+  uint64_t *words;
+
+  /** Position of the most recent outcome in the ring */
+  unsigned head;
+
+  /** Ring size in bits minus one, the size being a power of two */
+  unsigned mask;
+};
+
+#endif
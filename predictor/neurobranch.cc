@@ -15,76 +15,111 @@
 
 NeuroBP::NeuroBP(const NeuroBPParams *params)
   : BPredUnit(params),
+	historyPool(params->numThreads),
 	globalPredictorSize(params->globalPredictorSize),
-	globalHistory(params->numThreads, 0),
-	globalHistoryBits(ceilLog2(params->globalPredictorSize))
+	globalHistory(params->numThreads),
+	globalHistoryWords(params->numThreads *
+					   HistoryRegister::storageWords(
+						 params->globalPredictorSize), 0),
+	perceptronCount(params->perceptronCount),
+	trained(0),
+	historyBits((params->globalPredictorSize + 63) / 64, 0),
+	kernel(perceptronKernel())
 {  
   if (!isPowerOf2(globalPredictorSize)) {
 	fatal("Invalid global predictor size!\n");
   }
 	
-  // Set up historyRegisterMask
-  historyRegisterMask = mask(globalHistoryBits);
+  // Set up the history registers, each over its own part of the
+  // storage
+  const unsigned words = HistoryRegister::storageWords(globalPredictorSize);
+  for (ThreadID tid = 0; tid < (ThreadID)numThreads; tid++) {
+	globalHistory[tid].attach(&globalHistoryWords[tid * words],
+							  globalPredictorSize);
+  }
 
   // number of hashed perceptrons, i.e. each
   // one act as a local predictor corresponding to local history
-  perceptronCount = 20;
+  if (perceptronCount == 0) {
+	fatal("Invalid perceptron count!\n");
+  }
 
   // Perceptron theta threshold parameter empirically determined in the
   // fast neural branch predictor paper to be 1.93 * history + 14
-  theta = 1.93 * globalPredictorSize + 14;
+  theta.init(1.93 * globalPredictorSize + 14, perceptronCount,
+			 params->adaptiveTheta, params->thetaPerPerceptron);
   
   // weights per neuron (historyRegister per neuron)
-  weightsTable.assign(perceptronCount,
-					  std::vector<unsigned>(globalPredictorSize + 1, 0));
+  weightsTable.assign(perceptronCount, globalPredictorSize + 1,
+					  params->weightBits);
+
+  // use the hot path compiled for the weight width
+  if (weightsTable.wide()) {
+	lookupFn = &NeuroBP::typedLookup<int16_t>;
+	updateFn = &NeuroBP::typedUpdate<int16_t>;
+  } else {
+	lookupFn = &NeuroBP::typedLookup<int8_t>;
+	updateFn = &NeuroBP::typedUpdate<int8_t>;
+  }
 }
 
 inline
 void
 NeuroBP::updateGlobalHistTaken(ThreadID tid)
 {
-  globalHistory[tid] = (globalHistory[tid] << 1) | 1;
-  globalHistory[tid] = globalHistory[tid] & historyRegisterMask;
+  globalHistory[tid].push(true);
 }
 
 inline
 void
 NeuroBP::updateGlobalHistNotTaken(ThreadID tid)
 {
-  globalHistory[tid] = (globalHistory[tid] << 1);
-  globalHistory[tid] = globalHistory[tid] & historyRegisterMask;
+  globalHistory[tid].push(false);
 }
 
 void
 NeuroBP::btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
     //Update Global History to Not Taken (clear LSB)
-    globalHistory[tid] &= (historyRegisterMask & ~ULL(1));
+    globalHistory[tid].set(0, false);
 }
 
 bool
 NeuroBP::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
+{
+  return (this->*lookupFn)(tid, branch_addr, bp_history);
+}
+
+template <class W>
+bool
+NeuroBP::typedLookup(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
   // the current perceptron weights correspond to the ones
   // being hashed from the program counter and number of perceptrons
-  int curPerceptron = branch_addr % perceptronCount; 
-  unsigned thread_history = globalHistory[tid];
+  const W *weights = weightsTable.row<W>(branch_addr % perceptronCount);
+  HistoryRegister::Checkpoint checkpoint = globalHistory[tid].checkpoint();
+  globalHistory[tid].read(checkpoint, historyBits.data(),
+						  globalPredictorSize);
   
   // the prediction is an indicator of the signed weighted sum
-  int y_out = weightsTable[curPerceptron][0];
-  for (int i = 1; i <= globalPredictorSize; i++) {
-	if ((thread_history >> (i - 1)) & 1)
-	  y_out += weightsTable[curPerceptron][i];
-	else y_out -= weightsTable[curPerceptron][i];
-  }
+  int y_out = weights[0] +
+	kernel.dot(weights + 1, historyBits.data(), globalPredictorSize);
   
   bool prediction = (y_out >= 0);
   
-  // Create BPHistory and pass it back to be recorded.
-  BPHistory *history       = new BPHistory;
-  history->globalHistory   = globalHistory[tid];
+  // Create BPHistory and pass it back to be recorded. The output and
+  // the history it was computed from are kept so that update can train
+  // against exactly what was used for the prediction.
+  BPHistory *history       = historyPool.allocate(tid);
+  history->globalHistory   = checkpoint;
   history->globalPredTaken = prediction;
+  history->globalUsed      = true;
+  history->yOut            = y_out;
   bp_history = (void *)history;
+
+  // Speculatively update the global history with the prediction
+  if (prediction) updateGlobalHistTaken(tid);
+  else            updateGlobalHistNotTaken(tid);
   
   return prediction;
 }
@@ -93,10 +128,11 @@ void
 NeuroBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
 {  
   // Create BPHistory and pass it back to be recorded.
-  BPHistory *history       = new BPHistory;
-  history->globalHistory   = globalHistory[tid];
+  BPHistory *history       = historyPool.allocate(tid);
+  history->globalHistory   = globalHistory[tid].checkpoint();
   history->globalPredTaken = true;
-  history->globalUsed      = true;
+  history->globalUsed      = false;
+  history->yOut            = 0;
   bp_history = static_cast<void *>(history);
   updateGlobalHistTaken(tid);
 }
@@ -104,39 +140,59 @@ NeuroBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
 void
 NeuroBP::update(ThreadID tid, Addr branch_addr, bool taken,
 				void *bp_history, bool squashed)
+{
+  (this->*updateFn)(tid, branch_addr, taken, bp_history, squashed);
+}
+
+template <class W>
+void
+NeuroBP::typedUpdate(ThreadID tid, Addr branch_addr, bool taken,
+					 void *bp_history, bool squashed)
 {
   assert(bp_history);
+  BPHistory *history = static_cast<BPHistory *>(bp_history);
   
-  int curPerceptron = branch_addr % perceptronCount; 
-  unsigned thread_history = globalHistory[tid];
-  
-  // the prediction is an indicator of the signed weighted sum
-  int y_out = weightsTable[curPerceptron][0];
-  for (int i = 1; i <= globalPredictorSize; i++) {
-	if ((thread_history >> (i - 1)) & 1)
-	  y_out += weightsTable[curPerceptron][i];
-	else y_out -= weightsTable[curPerceptron][i];
+  // If this is a misprediction, restore the speculatively updated
+  // global history and shift in the actual outcome instead. Training
+  // is left to the update done when the branch commits.
+  if (squashed) {
+	globalHistory[tid].restore(history->globalHistory);
+	globalHistory[tid].push(taken);
+	return;
   }
-  
-  // If this is a misprediction, restore the speculatively
-  // updated state (global history register and local history)
-  // and update again.
-  if (squashed || (abs(y_out) <= theta)) {	
-	if (taken) weightsTable[curPerceptron][0] += 1;
-	else       weightsTable[curPerceptron][0] -= 1;
+
+  // Train only on a misprediction or when the output recorded at
+  // lookup was not confidently beyond the threshold, which adapts to
+  // how often each happens. Unconditional branches never went through
+  // the perceptron.
+  const unsigned row = branch_addr % perceptronCount;
+  bool train = false;
+  if (history->globalUsed) {
+	if (history->globalPredTaken != taken) {
+	  theta.mispredicted(row);
+	  train = true;
+	} else if ((unsigned)abs(history->yOut) <= theta[row]) {
+	  theta.weaklyCorrect(row);
+	  train = true;
+	}
+  }
+
+  if (train) {
+	trained++;
+	W *weights = weightsTable.row<W>(row);
+	globalHistory[tid].read(history->globalHistory, historyBits.data(),
+							globalPredictorSize);
+
+	weights[0] = weightsTable.saturate(weights[0], taken);
 	
 	// Have to update the corresponding weights to negatively reinforce
 	// the outcome of having predicted incorrectly
-	for (int i = 1; i < globalPredictorSize; i++) {
-	  if (((thread_history >> (i - 1)) & 1) == taken)
-		weightsTable[curPerceptron][i]    += 1;
-	  else weightsTable[curPerceptron][i] -= 1;
-	}
+	kernel.train(weights + 1, historyBits.data(), globalPredictorSize - 1,
+				 taken, weightsTable.minimum(), weightsTable.maximum());
   }
-  
-  // Global history restore and update
-  globalHistory[tid] = (globalHistory[tid] << 1) | taken;
-  globalHistory[tid] &= historyRegisterMask;
+
+  // The branch has committed, so its BPHistory is no longer needed
+  historyPool.release(tid, history);
 }
 
 void
@@ -145,16 +201,17 @@ NeuroBP::squash(ThreadID tid, void *bp_history)
   BPHistory *history = static_cast<BPHistory *>(bp_history);
 
   // Restore global history to state prior to this branch.
-  globalHistory[tid] = history->globalHistory;
+  globalHistory[tid].restore(history->globalHistory);
 
-  // Delete this BPHistory now that we're done with it.
-  delete history;
+  // Return this BPHistory to the pool now that we're done with it.
+  historyPool.release(tid, history);
 }
 
 unsigned
 NeuroBP::getGHR(ThreadID tid, void *bp_history) const
 {
-  return static_cast<BPHistory *>(bp_history)->globalHistory;
+  return globalHistory[tid].low(
+	static_cast<BPHistory *>(bp_history)->globalHistory);
 }
 
 NeuroBP*
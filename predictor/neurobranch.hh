@@ -15,6 +15,11 @@
 
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/history_register.hh"
+#include "cpu/pred/perceptron_kernel.hh"
+#include "cpu/pred/perceptron_weights.hh"
+#include "cpu/pred/training_threshold.hh"
 #include "cpu/pred/sat_counter.hh"
 #include "params/NeuroBP.hh"
 
@@ -74,6 +79,9 @@ public:
 
   unsigned getGHR(ThreadID tid, void *bp_history) const;
 
+  /** Number of times the perceptron weights were trained so far */
+  uint64_t trainedBranches() const { return trained; }
+
 private:
   /** Updates global history as taken. */
   inline void updateGlobalHistTaken(ThreadID tid);
@@ -81,6 +89,18 @@ private:
   /** Updates global history as not taken. */
   inline void updateGlobalHistNotTaken(ThreadID tid);
 
+  /** lookup and update for one weight type (int8_t or int16_t) */
+  template <class W>
+  bool typedLookup(ThreadID tid, Addr branch_addr, void * &bp_history);
+
+  template <class W>
+  void typedUpdate(ThreadID tid, Addr branch_addr, bool taken,
+                   void *bp_history, bool squashed);
+
+  /** lookup and update instantiated for the weight width */
+  bool (NeuroBP::*lookupFn)(ThreadID, Addr, void * &);
+  void (NeuroBP::*updateFn)(ThreadID, Addr, bool, void *, bool);
+
   /**
    * The branch history information that is created upon predicting
    * a branch.  It will be passed back upon updating and squashing,
@@ -88,41 +108,50 @@ private:
    * state properly.
    */
   struct BPHistory {
-	unsigned globalHistory;
+	/** Global history checkpoint at the time of the prediction */
+	HistoryRegister::Checkpoint globalHistory;
 	bool globalPredTaken;
+	/** Whether the perceptron was used, i.e. for conditional branches */
 	bool globalUsed;
+	/** Perceptron output the prediction was made from */
+	int yOut;
   };
 
+  /** Recycled BPHistory records, released on squash and commit */
+  HistoryPool<BPHistory> historyPool;
+
   /** Number of entries in the global predictor. */
   unsigned globalPredictorSize;
 
-  /** Global history register - used for only the outcomes of 
-   *  branches as they are executed. Contains as much history as specified by
-   *  globalHistoryBits. Actual number of bits used is determined by
-   *  globalHistoryMask and choiceHistoryMask. */
-  std::vector<unsigned> globalHistory;
-  
-  /** Number of bits for the global history. Determines maximum number of
-	  entries in global and choice predictor tables. */
-  unsigned globalHistoryBits;
-
-  /** Mask to apply to globalHistory to access global history table.
-   *  Based on globalPredictorSize.*/
-  unsigned globalHistoryMask;
+  /** Global history register of each thread - used for only the
+   *  outcomes of branches as they are executed. Keeps the outcomes of
+   *  the last globalPredictorSize branches, one per perceptron input. */
+  std::vector<HistoryRegister> globalHistory;
 
-  /** Mask to control how much history is stored. All of it might not be
-   *  used. */
-  unsigned historyRegisterMask;
+  /** Storage of the global history registers */
+  std::vector<uint64_t> globalHistoryWords;
 
-  /** Perceptron weights for neural branch predictor */
+  /** Number of perceptrons, the one of a branch being chosen by its
+   *  address modulo perceptronCount */
   unsigned perceptronCount;
 
   /** Perceptron theta threshold parameter empirically estimated in the
-   fast neural branch predictor paper to be 1.93 * history + 14 */
-  unsigned theta;
+   fast neural branch predictor paper to be 1.93 * history + 14, or
+   adapted from that starting point, globally or per perceptron */
+  TrainingThreshold theta;
+
+  /** Training passes so far, see trainedBranches() */
+  uint64_t trained;
   
-  /** Perceptron weights for neural branch predictor */
-  std::vector<std::vector<unsigned>> weightsTable;
+  /** Perceptron weights for neural branch predictor, saturating
+   *  weightBits-bit values */
+  PerceptronWeights weightsTable;
+
+  /** History bits of the current lookup/update, one per weight */
+  std::vector<uint64_t> historyBits;
+
+  /** Weighted sum/training kernels for the host instruction set */
+  const PerceptronKernel &kernel;
 };
 
 #endif
@@ -8,199 +8,371 @@
 
 #include "cpu/pred/neuropath.hh"
 
+#include <algorithm>
 #include <iostream>
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 
 NeuroPathBP::NeuroPathBP(const NeuroPathBPParams *params)
+  : NeuroPathBP(params, 1)
+{
+}
+
+NeuroPathBP::NeuroPathBP(const NeuroPathBPParams *params, unsigned pc_count)
   : BPredUnit(params),
+	historyPool(params->numThreads),
 	globalPredictorSize(params->globalPredictorSize),
-	G (params->numThreads, 0), // 0-initialize global history, entries <=> threads
-	SG(params->numThreads, 0), // 0-initialize speculative history
-	globalHistoryBits(ceilLog2(params->globalPredictorSize))
+	historyBits((params->globalPredictorSize + 1 + 63) / 64, 0),
+	perceptronCount(params->perceptronCount),
+	pcCount(pc_count),
+	trained(0)
 {  
   if (!isPowerOf2(globalPredictorSize)) {
 	fatal("Invalid global predictor size!\n");
   }
 
-  // Set up the global history mask
-  // this is equivalent to mask(log2(globalPredictorSize)
-  globalHistoryMask = globalPredictorSize - 1;
-	
-  // Set up historyRegisterMask
-  historyRegisterMask = mask(globalHistoryBits);
+  if (pcCount == 0) {
+	fatal("Invalid number of weight sets!\n");
+  }
 
-  // Check that predictors don't use more bits than they have available
-  if (globalHistoryMask > historyRegisterMask)
-	fatal("Global predictor too large for global history bits!\n");
+  // (speculative) running totals computing the perceptron output
+  // each entry j corresponds to partial sum of j steps forward, one
+  // buffer of them per weight set
+  sumsSize = globalPredictorSize + 1;
 
-  // speculative running total computing the perceptron output
-  // each entry j corresponds to partial sum of j steps forward
-  SR.assign(globalPredictorSize + 1, 0);
+  // path ring with room for the addresses in use plus those of the
+  // branches in flight, rounded up so positions can be masked
+  unsigned pathCapacity =
+	1 << ceilLog2(globalPredictorSize + 1 + maxBranchesInFlight);
+  pathMask = pathCapacity - 1;
 
-  // running total computing the perceptron output
-  // each entry j corresponds to partial sum of j steps forward
-  R.assign(globalPredictorSize + 1, 0);
+  // global histories of the outcomes of the last H + 1 branches, the
+  // weight j of a branch going with the outcome j branches before
+  const unsigned history_words =
+	HistoryRegister::storageWords(globalPredictorSize + 1);
+
+  // per-thread blocks: the ThreadState header, then R, SR, path, G and
+  // SG, each starting on its own cache line
+  const size_t line = cacheLineSize;
+  const size_t header_size  = roundUp(sizeof(ThreadState), line);
+  const size_t sums_bytes   =
+	roundUp(pcCount * sumsSize * sizeof(unsigned), line);
+  const size_t path_bytes   = roundUp(pathCapacity * sizeof(unsigned), line);
+  const size_t history_bytes =
+	roundUp(history_words * sizeof(uint64_t), line);
+  threadBlockSize = header_size + 2 * sums_bytes + path_bytes +
+	2 * history_bytes;
+
+  // zero-initializes every history, running total and path
+  threadArena.assign(numThreads * threadBlockSize + line, 0);
+  threadBase = &threadArena[0] +
+	((line - (uintptr_t)&threadArena[0] % line) % line);
+
+  for (ThreadID tid = 0; tid < (ThreadID)numThreads; tid++) {
+	char *block = threadBase + tid * threadBlockSize;
+	ThreadState &state = thread(tid);
+	state.R    = reinterpret_cast<unsigned *>(block + header_size);
+	state.SR   = reinterpret_cast<unsigned *>(block + header_size +
+												sums_bytes);
+	state.path = reinterpret_cast<unsigned *>(block + header_size +
+												2 * sums_bytes);
+	char *histories = block + header_size + 2 * sums_bytes + path_bytes;
+	state.G.attach(reinterpret_cast<uint64_t *>(histories),
+				   globalPredictorSize + 1);
+	state.SG.attach(reinterpret_cast<uint64_t *>(histories + history_bytes),
+					globalPredictorSize + 1);
+  }
 
   // number of hashed perceptrons, i.e. each
   // one act as a local predictor corresponding to local history
-  perceptronCount = 10;
+  if (perceptronCount == 0) {
+	fatal("Invalid perceptron count!\n");
+  }
 
   // Perceptron theta threshold parameter empirically determined in the
   // fast neural branch predictor paper to be 2.14 * history + 20.58
-  theta = 2.14 * (globalPredictorSize + 1) + 20.58;
-  
-  // weights per neuron (historyRegister per neuron)
-  weightsTable.assign(perceptronCount,
-					  std::vector<unsigned>(globalPredictorSize + 1, 0));
+  theta.init(2.14 * (globalPredictorSize + 1) + 20.58, perceptronCount,
+			 params->adaptiveTheta, params->thetaPerPerceptron);
   
-  // figure out max and min weights values
-  max_weight = (1 << (globalHistoryBits - 1)) - 1;
-  min_weight = -(max_weight + 1);
+  // weights per neuron (historyRegister per neuron), perceptronCount
+  // of them in each weight set
+  weightsTable.assign(pcCount * perceptronCount, globalPredictorSize + 1,
+					  params->weightBits);
+
+  // use the hot path compiled for the weight width
+  if (weightsTable.wide()) {
+	lookupFn = &NeuroPathBP::typedLookup<int16_t>;
+	updateFn = &NeuroPathBP::typedUpdate<int16_t>;
+  } else {
+	lookupFn = &NeuroPathBP::typedLookup<int8_t>;
+	updateFn = &NeuroPathBP::typedUpdate<int8_t>;
+  }
+}
+
+inline
+NeuroPathBP::ThreadState &
+NeuroPathBP::thread(ThreadID tid)
+{
+  return *reinterpret_cast<ThreadState *>(threadBase +
+										  tid * threadBlockSize);
 }
 
 void
 NeuroPathBP::btbUpdate(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
     //Update Global History to Not Taken (clear LSB)
-    G[tid] &= (historyRegisterMask & ~ULL(1));
+    thread(tid).G.set(0, false);
 }
 
 void
 inline
-NeuroPathBP::updatePath(Addr branch_addr)
+NeuroPathBP::updatePath(ThreadState &state, Addr branch_addr)
 {
-  path.insert(path.begin(), branch_addr);
+  state.pathHead = (state.pathHead - 1) & pathMask;
+  state.path[state.pathHead] = branch_addr;
   // only maintains the last H (globalPredictorSize) addresses in history
-  if (path.size() > (globalPredictorSize + 1)) path.pop_back();
+  if (state.pathSize < globalPredictorSize + 1) state.pathSize++;
+}
+
+inline
+unsigned
+NeuroPathBP::pathAt(const ThreadState &state, unsigned i) const
+{
+  return state.path[(state.pathHead + i) & pathMask];
+}
+
+inline
+unsigned
+NeuroPathBP::weightSet(Addr addr) const
+{
+  // a plain path-based predictor has a single set, spare it the divide
+  return pcCount == 1 ? 0 : addr % pcCount;
 }
 
+inline
 unsigned
-NeuroPathBP::saturatedUpdate (unsigned weight, bool inc) {
-  if      ( inc && (weight < max_weight)) return weight + 1;
-  else if (!inc && (weight > min_weight)) return weight - 1;
-  return weight;
+NeuroPathBP::runningSum(const unsigned *sums, unsigned head,
+                        unsigned j) const
+{
+  return sums[head >= j ? head - j : head + sumsSize - j];
+}
+
+namespace
+{
+
+/** Adds (or subtracts) n weights to n running totals */
+template <class W>
+inline void
+addWeights(unsigned *sums, const W *weights, unsigned n, bool taken)
+{
+  if (taken) for (unsigned i = 0; i < n; i++) sums[i] += weights[i];
+  else       for (unsigned i = 0; i < n; i++) sums[i] -= weights[i];
+}
+
+/** Adds one row of weights to the two runs of a running total buffer */
+template <class W>
+inline void
+addWeightRuns(unsigned *sums, const W *weights, unsigned size,
+              unsigned head, bool taken)
+{
+  // every slot q other than head holds the total (head - q) mod size
+  // steps forward, which takes weight (q - head) mod size
+  addWeights(sums + head + 1, weights + 1, size - 1 - head, taken);
+  addWeights(sums, weights + size - head, head, taken);
+}
+
+} // anonymous namespace
+
+template <class W>
+void
+NeuroPathBP::advanceSums(unsigned *sums, unsigned &head, unsigned size,
+                         const W *weights, bool taken)
+{
+  head = (head + 1 == size) ? 0 : head + 1;
+
+  // every weight set has its own totals, moving along with the others,
+  // which the branch adds its perceptron of that set to
+  const size_t set_stride = (size_t)perceptronCount * size;
+  for (unsigned set = 0; set < pcCount; set++) {
+	unsigned *set_sums = sums + set * size;
+
+	// the slot freed by the oldest total becomes the total 0 steps
+	// forward
+	set_sums[head] = 0;
+
+	addWeightRuns(set_sums, weights + set * set_stride, size, head, taken);
+  }
+}
+
+void
+NeuroPathBP::restoreSpeculative(ThreadState &state)
+{
+  state.SG.copyFrom(state.G);
+  std::copy(state.R, state.R + pcCount * sumsSize, state.SR);
+  state.SRHead = state.RHead;
 }
 
 bool
 NeuroPathBP::lookup(ThreadID tid, Addr branch_addr, void * &bp_history)
 {
-  updatePath(branch_addr);
+  return (this->*lookupFn)(tid, branch_addr, bp_history);
+}
+
+template <class W>
+bool
+NeuroPathBP::typedLookup(ThreadID tid, Addr branch_addr,
+						 void * &bp_history)
+{
+  ThreadState &state = thread(tid);
+  unsigned path_head = state.pathHead;
+  unsigned path_size = state.pathSize;
+  updatePath(state, branch_addr);
 
-  unsigned k_j;
   // the current perceptron weights correspond to the ones
-  // being hashed from the program counter and number of perceptrons
-  int curPerceptron = branch_addr % perceptronCount; 
-  int y_out         = weightsTable[curPerceptron][0] +
-	SR[globalPredictorSize];
+  // being hashed from the program counter and number of perceptrons;
+  // the output is read from the totals of the weight set of the branch
+  const unsigned set = weightSet(branch_addr);
+  const unsigned row = branch_addr % perceptronCount;
+  const W *weights  = weightsTable.row<W>(row);
+  int y_out         = weightsTable.row<W>(set * perceptronCount + row)[0] +
+	runningSum(state.SR + set * sumsSize, state.SRHead,
+			 globalPredictorSize);
   bool prediction   = (y_out >= 0);
 
   // Create BPHistory and pass it back to be recorded.
-  BPHistory *history = new BPHistory;
-  history->globalHistory   = SG[tid];
+  BPHistory *history = historyPool.allocate(tid);
+  history->globalHistory   = state.SG.low(state.SG.checkpoint());
   history->globalPredTaken = prediction;
+  history->pathHead        = path_head;
+  history->pathSize        = path_size;
   bp_history = (void *)history;
 
-  std::vector<unsigned> SR_prime;
-  SR_prime.assign(globalPredictorSize + 1, 0);
+  advanceSums(state.SR, state.SRHead, globalPredictorSize + 1, weights,
+			  prediction);
   
-  for (int j = 1; j <= globalPredictorSize; j++) {
-	k_j = globalPredictorSize - j;
-	SR_prime[k_j + 1] = SR[k_j];
-	// case where the prediction is "taken"
-	if (prediction) SR_prime[k_j + 1] += weightsTable[curPerceptron][j];
-	else            SR_prime[k_j + 1] -= weightsTable[curPerceptron][j];
-  }
-
-  SR    = SR_prime;
-  SR[0] = 0;
-  
-  SG[tid] = ((SG[tid] << 1) | prediction);
-  SG[tid] = (SG[tid] & historyRegisterMask);
+  state.SG.push(prediction);
   return prediction;
 }
 
 void
 NeuroPathBP::uncondBranch(ThreadID tid, Addr pc, void * &bp_history)
 {
+  ThreadState &state = thread(tid);
+
   // Create BPHistory and pass it back to be recorded.
-  BPHistory *history = new BPHistory;
-  history->globalHistory = SG[tid];
+  BPHistory *history = historyPool.allocate(tid);
+  history->globalHistory = state.SG.low(state.SG.checkpoint());
   history->globalPredTaken = true;
   history->globalUsed = true;
+  history->pathHead = state.pathHead;
+  history->pathSize = state.pathSize;
   bp_history = static_cast<void *>(history);
 
-  updatePath(pc);  
-  SG[tid] = ((SG[tid] << 1) | 1);
-  SG[tid] &= historyRegisterMask;
+  updatePath(state, pc);  
+  state.SG.push(true);
 }
 
 void
 NeuroPathBP::update(ThreadID tid, Addr branch_addr, bool taken,
 				void *bp_history, bool squashed)
 {
-  assert(bp_history);
-  unsigned k, k_j;
-  int curPerceptron = branch_addr % perceptronCount; 
-  int y_out         = weightsTable[curPerceptron][0] +
-	SR[globalPredictorSize];
-  
-  unsigned thread_history = SG[tid];
+  (this->*updateFn)(tid, branch_addr, taken, bp_history, squashed);
+}
 
-  // maintain R in case the history got squashed
-  std::vector<unsigned> R_prime;
-  R_prime.assign(globalPredictorSize + 1, 0);
+template <class W>
+void
+NeuroPathBP::typedUpdate(ThreadID tid, Addr branch_addr, bool taken,
+						 void *bp_history, bool squashed)
+{
+  assert(bp_history);
+  const unsigned columns = globalPredictorSize + 1;
+  ThreadState &state = thread(tid);
+  const unsigned row = branch_addr % perceptronCount;
+  const unsigned set = weightSet(branch_addr);
+  W *weights         = weightsTable.row<W>(0);
+  W *set_weights     = weights + (size_t)set * perceptronCount * columns;
+  W *cur_weights     = set_weights + row * columns;
+  int y_out          = cur_weights[0] +
+	runningSum(state.SR + set * sumsSize, state.SRHead,
+			 globalPredictorSize);
   
-  for (int j = 1; j <= globalPredictorSize; j++) {
-	k_j = globalPredictorSize - j;
-	R_prime[k_j + 1] = R[k_j];
-	// case where the prediction is "taken"
-	if (taken) R_prime[k_j + 1] += weightsTable[curPerceptron][j];
-	else       R_prime[k_j + 1] -= weightsTable[curPerceptron][j];
+  // If this is a misprediction, or the output was not confidently
+  // beyond the threshold, the weights get trained on the speculative
+  // history, which a misprediction is about to roll back. The
+  // threshold adapts to how often each happens; the commit of a
+  // mispredicted branch was already counted by its squashing update.
+  bool train = squashed;
+  if (squashed) {
+	theta.mispredicted(row);
+  } else if ((unsigned)abs(y_out) <= theta[row]) {
+	train = true;
+	if (static_cast<BPHistory *>(bp_history)->globalPredTaken == taken)
+	  theta.weaklyCorrect(row);
+  }
+  if (train) {
+	state.SG.read(state.SG.checkpoint(), historyBits.data(), columns);
   }
 
-  R    = R_prime;
-  R[0] = 0;
+  // maintain R in case the history got squashed
+  advanceSums(state.R, state.RHead, columns, weights + row * columns, taken);
 
   // Update non-speculative global history shift register
-  G[tid] = ((G[tid] << 1) | taken);
-  G[tid] &= historyRegisterMask;
+  state.G.push(taken);
   
   // If this is a misprediction, restore the speculatively
   // updated state (global history register and local history)
   // and update again.
-  if (squashed || (abs(y_out) <= theta)) {
+  if (train) {
+	trained++;
 	if (squashed) {
 	  // Global history restore and update
-	  SG[tid] = G[tid];
-	  SR = R;
+	  restoreSpeculative(state);
+
+	  // Drop the path of the younger (wrong path) branches
+	  BPHistory *history = static_cast<BPHistory *>(bp_history);
+	  state.pathHead = history->pathHead;
+	  state.pathSize = history->pathSize;
+	  updatePath(state, branch_addr);
 	}
 	
-	weightsTable[curPerceptron][0] = saturatedUpdate(
-	    weightsTable[curPerceptron][0], taken);
-	for (int j = 1; j <= globalPredictorSize; j++) {
-	  // weight is chosen mod path.size in the edge case of short history
-	  k = (path[j % path.size()] % perceptronCount); 
-	  weightsTable[k][j] = saturatedUpdate(weightsTable[k][j],
-	      ((thread_history >> j) & 1) == taken);
+	cur_weights[0] = weightsTable.saturate(cur_weights[0], taken);
+
+	// weight is chosen mod pathSize in the edge case of short history,
+	// which once the path is full is the age itself
+	const unsigned path_size = state.pathSize;
+	const bool full          = path_size == columns;
+	for (unsigned j = 1; j <= globalPredictorSize; j++) {
+	  unsigned age = full ? j : j % path_size;
+	  W &weight    =
+		set_weights[pathAt(state, age) % perceptronCount * columns + j];
+	  bool outcome = (historyBits[j >> 6] >> (j & 63)) & 1;
+	  weight = weightsTable.saturate(weight, outcome == taken);
 	}
   }
+
+  // The branch has committed, so its BPHistory is no longer needed
+  if (!squashed) {
+	historyPool.release(tid, static_cast<BPHistory *>(bp_history));
+  }
 }
 
 void
 NeuroPathBP::squash(ThreadID tid, void *bp_history)
 {
   BPHistory *history = static_cast<BPHistory *>(bp_history);
+  ThreadState &state = thread(tid);
 
-  // Restore global history to state prior to this branch.
-  SG[tid] = G[tid];
+  // Restore global history to state prior to this branch, and SR to
+  // a non-speculative version computed using only non-speculative
+  // information
+  restoreSpeculative(state);
 
-  // Restore SR to a non-speculative version computed end if
-  // using only non-speculative information
-  SR = R;
+  // Restore the path to its state prior to this branch
+  state.pathHead = history->pathHead;
+  state.pathSize = history->pathSize;
   
-  // Delete this BPHistory now that we're done with it.
-  delete history;
+  // Return this BPHistory to the pool now that we're done with it.
+  historyPool.release(tid, history);
 }
 
 unsigned
@@ -14,6 +14,10 @@
 
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/history_pool.hh"
+#include "cpu/pred/history_register.hh"
+#include "cpu/pred/perceptron_weights.hh"
+#include "cpu/pred/training_threshold.hh"
 #include "cpu/pred/sat_counter.hh"
 #include "params/NeuroPathBP.hh"
 
@@ -73,20 +77,142 @@ public:
 
   unsigned getGHR(ThreadID tid, void *bp_history) const;
 
+  /** Number of times the perceptron weights were trained so far (a
+   *  mispredicted branch may train both when squashed and at commit) */
+  uint64_t trainedBranches() const { return trained; }
+
+protected:
+  /**
+   * Constructor of the piecewise-linear generalization of the
+   * predictor (see PiecewiseLinearBP), where the weights are further
+   * selected by the address of the branch being predicted, out of
+   * pc_count weight sets. There are as many running totals, so that
+   * the output of a branch is still ready when it is looked up. With a
+   * single set this is the path-based predictor.
+   * @param params Parameters of the predictor
+   * @param pc_count Number of weight sets
+   */
+  NeuroPathBP(const NeuroPathBPParams *params, unsigned pc_count);
+
 private:
+  /**
+   * Speculative and non-speculative state of one hardware thread. Each
+   * thread gets its own cache line aligned block holding this header
+   * followed by its R, SR, path, G and SG buffers, so that threads neither
+   * corrupt nor falsely share each other's state.
+   */
+  struct ThreadState {
+	/** Global history register, denoted G in this version to match the
+	 *  notation from the paper. Keeps the outcomes of the last
+	 *  globalPredictorSize + 1 branches. */
+	HistoryRegister G;
+
+	/** Speculative global history register, denoted SG in this version
+	 *  to match notation from the paper. Contains prediction history for
+	 *  the same size as that of the true history global register. */
+	HistoryRegister SG;
+
+	/** Running total computing the perceptron output steps
+	    in the future (in reality). Kept as a circular buffer of
+	    globalPredictorSize + 1 entries: the total j steps forward is at
+	    (RHead - j) mod (globalPredictorSize + 1), so moving every total
+	    one step forward only moves the head. There is one such buffer
+	    per weight set, one after the other, sharing the head. */
+	unsigned *R;
+
+	/** Position of the total 0 steps forward in R */
+	unsigned RHead;
+
+	/** Speculative running total computing the perceptron output steps
+	    in the future (in reality). Circular buffer laid out as R. */
+	unsigned *SR;
+
+	/** Position of the total 0 steps forward in SR */
+	unsigned SRHead;
+
+	/** History of the path the CPU has travelled through the program
+	    trace, i.e. the previous h branch instruction addresses. These are
+	    used for prediction, i.e. multiple inputs. Kept as a ring written
+	    backwards from pathHead, so that adding a branch is O(1) and the
+	    whole path can be checkpointed as (pathHead, pathSize). The ring
+	    holds maxBranchesInFlight addresses more than the
+	    globalPredictorSize + 1 in use, so that branches in flight do not
+	    overwrite a checkpointed path before it is restored. */
+	unsigned *path;
+
+	/** Position of the most recent address in path */
+	unsigned pathHead;
+
+	/** Number of addresses in use in path, at most
+	 *  globalPredictorSize + 1 */
+	unsigned pathSize;
+  };
+
+  /** Returns the state of the given thread */
+  inline ThreadState &thread(ThreadID tid);
+
   /**
    * Updates the global path tracking instance variable to include
    * newly encountered branch instruction
+   * @param state State of the thread the branch belongs to
    * @param branch_addr Address object containing memory location obj
    */
-  void inline updatePath(Addr branch_addr);
+  void inline updatePath(ThreadState &state, Addr branch_addr);
 
   /**
-   * Updates the corresponding weight parameter w/ saturation factor
-   * @param weight Current value of weight to be updated
-   * @param inc Whether the weight is to be incremented or decremented
+   * Returns an address of the path history
+   * @param state State of the thread whose path is read
+   * @param i Age of the address, 0 being the most recent branch
    */
-  unsigned saturatedUpdate (unsigned weight, bool inc);
+  inline unsigned pathAt(const ThreadState &state, unsigned i) const;
+
+  /** Weight set of the branch at the given address */
+  inline unsigned weightSet(Addr addr) const;
+
+  /**
+   * Returns the running total j steps forward out of a circular buffer
+   * of running totals (see ThreadState::R and ThreadState::SR).
+   * @param sums Circular buffer of running totals
+   * @param head Position of the total 0 steps forward
+   * @param j Number of steps forward
+   */
+  inline unsigned runningSum(const unsigned *sums, unsigned head,
+                             unsigned j) const;
+
+  /**
+   * Moves a circular buffer of running totals one step forward and adds
+   * the weights of the given perceptron to every total, i.e. total j+1
+   * becomes total j plus (or minus) weight globalPredictorSize - j.
+   * There is one buffer per weight set, one after the other, each of
+   * which gets the perceptron out of its own set.
+   * @param sums Circular buffers of running totals
+   * @param head Position of the total 0 steps forward, moved by one
+   * @param size Number of totals, i.e. globalPredictorSize + 1
+   * @param weights Row of the perceptron of the branch in the first set
+   * @param taken Whether the weights are added or subtracted
+   */
+  template <class W>
+  void advanceSums(unsigned *sums, unsigned &head, unsigned size,
+                   const W *weights, bool taken);
+
+  /** lookup and update for one weight type (int8_t or int16_t) */
+  template <class W>
+  bool typedLookup(ThreadID tid, Addr branch_addr, void * &bp_history);
+
+  template <class W>
+  void typedUpdate(ThreadID tid, Addr branch_addr, bool taken,
+                   void *bp_history, bool squashed);
+
+  /** lookup and update instantiated for the weight width */
+  bool (NeuroPathBP::*lookupFn)(ThreadID, Addr, void * &);
+  void (NeuroPathBP::*updateFn)(ThreadID, Addr, bool, void *, bool);
+
+  /**
+   * Rolls the speculative state of a thread back to the
+   * non-speculative one, i.e. SG = G and SR = R.
+   * @param state State of the thread to be restored
+   */
+  void restoreSpeculative(ThreadState &state);
   
   /**
    * The branch history information that is created upon predicting
@@ -95,67 +221,66 @@ private:
    * state properly.
    */
   struct BPHistory {
+	/** Most recent 32 outcomes of the speculative history, for getGHR */
 	unsigned globalHistory;
 	bool globalPredTaken;
 	bool globalUsed;
+	/** Path history checkpoint, i.e. pathHead and pathSize prior
+	 *  to this branch */
+	unsigned pathHead;
+	unsigned pathSize;
   };
 
+  /** Recycled BPHistory records, released on squash and commit */
+  HistoryPool<BPHistory> historyPool;
+
   /** Number of entries in the global predictor. */
   unsigned globalPredictorSize;
-  
-  /** Global history register, denoted G in this version to match the
-   *  notation from the paper. Contains as much history as specified by
-   *  globalHistoryBits. Actual number of bits used is determined by
-   *  globalHistoryMask and choiceHistoryMask. */
-  std::vector<unsigned> G;
-
-  /** Speculative global history register, denoted SG in this version 
-   *  to match notation from the paper. Contains prediction history for
-   *  the same size as that of the true history global register, i.e.
-   *  globalHistoryBits. Actual number of bits used is determined by
-   *  globalHistoryMask and choiceHistoryMask. */
-  std::vector<unsigned> SG;
-  
-  /** Running total computing the perceptron output steps
-	  in the future (in reality). */
-  std::vector<unsigned> R;
-  
-  /** Speculative running total computing the perceptron output steps
-	  in the future (in reality). */
-  std::vector<unsigned> SR;
-  
-  /** History of the path the CPU has travelled through the program trace,
-      i.e. the previous h branch instruction addresses. These are used for
-	  prediction, i.e. multiple inputs. */
-  std::vector<unsigned> path;
-  
-  /** Number of bits for the global history. Determines maximum number of
-	  entries in global and choice predictor tables. */
-  unsigned globalHistoryBits;
 
-  /** Mask to apply to globalHistory to access global history table.
-   *  Based on globalPredictorSize.*/
-  unsigned globalHistoryMask;
+  /** Number of entries of the running total buffers R and SR */
+  unsigned sumsSize;
+
+  /** Mask applied to path positions, the ring size being a power of 2 */
+  unsigned pathMask;
+
+  /** Size in bytes of the state block of each thread, a multiple of the
+   *  cache line size */
+  size_t threadBlockSize;
 
-  /** Mask to control how much history is stored. All of it might not be
-   *  used. */
-  unsigned historyRegisterMask;
+  /** Backing storage of the per-thread state blocks, with slack to
+   *  align the first block on a cache line */
+  std::vector<char> threadArena;
 
-  /** Perceptron weights for neural branch predictor */
+  /** First per-thread state block, cache line aligned in threadArena */
+  char *threadBase;
+
+  /** Host cache line size the per-thread state blocks are padded to */
+  static const size_t cacheLineSize = 64;
+  
+  /** Speculative history bits a branch is trained on, read before a
+   *  squash rolls the speculative history back */
+  std::vector<uint64_t> historyBits;
+
+  /** Number of perceptrons, the one of a branch being chosen by its
+   *  address modulo perceptronCount */
   unsigned perceptronCount;
 
-  /** Perceptron theta threshold parameter empirically estimated in the
-   fast neural branch predictor paper to be 1.93 * history + 14 */
-  unsigned theta;
+  /** Number of weight sets of perceptronCount perceptrons, the one
+   *  used for a prediction being chosen by the address of the branch
+   *  predicted modulo pcCount; 1 for the path-based predictor */
+  unsigned pcCount;
 
-  /** Saturated value of the maximum weight on a branch */
-  unsigned max_weight;
+  /** Perceptron theta threshold parameter empirically estimated in the
+   fast neural branch predictor paper to be 2.14 * (history + 1) + 20.58,
+   or adapted from that starting point, globally or per perceptron */
+  TrainingThreshold theta;
 
-  /** Saturated value of the minimum weight on a branch */
-  unsigned min_weight;
+  /** Training passes so far, see trainedBranches() */
+  uint64_t trained;
 
-  /** Perceptron weights for neural branch predictor */
-  std::vector<std::vector<unsigned>> weightsTable;
+  /** Perceptron weights for neural branch predictor, saturating
+   *  weightBits-bit values */
+  PerceptronWeights weightsTable;
 };
 
 #endif
@@ -0,0 +1,305 @@
+/*****************************************************************
+ * File: perceptron_kernel.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Signed weighted sum and training kernels shared by
+ * the perceptron predictors, with scalar, AVX2 and AVX-512 versions
+ * selected at runtime.
+ ****************************************************************/
+
+#include "cpu/pred/perceptron_kernel.hh"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+inline bool
+historyBit(const uint64_t *history, unsigned i)
+{
+  return (history[i >> 6] >> (i & 63)) & 1;
+}
+
+/** Signed sum of weights [from, to), used for the vector tails too */
+template <class W>
+inline int
+signedSum(const W *weights, const uint64_t *history, unsigned from,
+          unsigned to)
+{
+  int sum = 0;
+  for (unsigned i = from; i < to; i++) {
+    // branchless negation: (w ^ neg) - neg is -w when neg is all-ones
+    int neg = -(int)!historyBit(history, i);
+    sum += (weights[i] ^ neg) - neg;
+  }
+  return sum;
+}
+
+/** Trains weights [from, to), used for the vector tails too */
+template <class W>
+inline void
+trainRange(W *weights, const uint64_t *history, unsigned from, unsigned to,
+           bool taken, int min_weight, int max_weight)
+{
+  for (unsigned i = from; i < to; i++) {
+    int w = weights[i];
+    if (historyBit(history, i) == taken) {
+      if (w < max_weight) weights[i] = w + 1;
+    } else {
+      if (w > min_weight) weights[i] = w - 1;
+    }
+  }
+}
+
+template <class W>
+int
+dotScalar(const W *weights, const uint64_t *history, unsigned n)
+{
+  return signedSum(weights, history, 0, n);
+}
+
+template <class W>
+void
+trainScalar(W *weights, const uint64_t *history, unsigned n, bool taken,
+            int min_weight, int max_weight)
+{
+  trainRange(weights, history, 0, n, taken, min_weight, max_weight);
+}
+
+#if defined(__x86_64__)
+
+/** Expands the 8 history bits starting at i into all-ones/zero lanes */
+__attribute__((target("avx2")))
+inline __m256i
+expandBits8(const uint64_t *history, unsigned i)
+{
+  const __m256i select = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  unsigned bits = (history[i >> 6] >> (i & 63)) & 0xff;
+  __m256i spread = _mm256_and_si256(_mm256_set1_epi32(bits), select);
+  return _mm256_cmpeq_epi32(spread, select);
+}
+
+/** Loads 8 weights sign-extended to 32-bit lanes */
+__attribute__((target("avx2")))
+inline __m256i
+load8(const int8_t *weights)
+{
+  return _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)weights));
+}
+
+__attribute__((target("avx2")))
+inline __m256i
+load8(const int16_t *weights)
+{
+  return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)weights));
+}
+
+/** Stores 8 in-range 32-bit lanes back as weights */
+__attribute__((target("avx2")))
+inline void
+store8(int8_t *weights, __m256i v)
+{
+  __m128i halves = _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                   _mm256_extracti128_si256(v, 1));
+  _mm_storel_epi64((__m128i *)weights, _mm_packs_epi16(halves, halves));
+}
+
+__attribute__((target("avx2")))
+inline void
+store8(int16_t *weights, __m256i v)
+{
+  _mm_storeu_si128((__m128i *)weights,
+                   _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                   _mm256_extracti128_si256(v, 1)));
+}
+
+template <class W>
+__attribute__((target("avx2")))
+int
+dotAVX2(const W *weights, const uint64_t *history, unsigned n)
+{
+  const __m256i ones = _mm256_set1_epi32(-1);
+  __m256i acc0 = _mm256_setzero_si256();
+  __m256i acc1 = _mm256_setzero_si256();
+  unsigned i = 0;
+
+  for (; i + 16 <= n; i += 16) {
+    // conditionally negate: (w ^ neg) - neg with neg = ~taken
+    __m256i neg0 = _mm256_xor_si256(expandBits8(history, i), ones);
+    __m256i neg1 = _mm256_xor_si256(expandBits8(history, i + 8), ones);
+    __m256i w0 = load8(weights + i);
+    __m256i w1 = load8(weights + i + 8);
+    acc0 = _mm256_add_epi32(acc0,
+      _mm256_sub_epi32(_mm256_xor_si256(w0, neg0), neg0));
+    acc1 = _mm256_add_epi32(acc1,
+      _mm256_sub_epi32(_mm256_xor_si256(w1, neg1), neg1));
+  }
+
+  __m256i acc = _mm256_add_epi32(acc0, acc1);
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                              _mm256_extracti128_si256(acc, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+
+  return _mm_cvtsi128_si32(sum) + signedSum(weights, history, i, n);
+}
+
+template <class W>
+__attribute__((target("avx2")))
+void
+trainAVX2(W *weights, const uint64_t *history, unsigned n, bool taken,
+          int min_weight, int max_weight)
+{
+  // lanes disagreeing with the outcome become all-ones, i.e. -1
+  const __m256i flip = _mm256_set1_epi32(taken ? -1 : 0);
+  const __m256i one  = _mm256_set1_epi32(1);
+  const __m256i lo   = _mm256_set1_epi32(min_weight);
+  const __m256i hi   = _mm256_set1_epi32(max_weight);
+  unsigned i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    __m256i disagree = _mm256_xor_si256(expandBits8(history, i), flip);
+    __m256i delta = _mm256_or_si256(disagree, one);
+    __m256i w = _mm256_add_epi32(load8(weights + i), delta);
+    w = _mm256_min_epi32(_mm256_max_epi32(w, lo), hi);
+    store8(weights + i, w);
+  }
+  trainRange(weights, history, i, n, taken, min_weight, max_weight);
+}
+
+// GCC 12 warns about the undefined pass-through operand of the unmasked
+// AVX-512 intrinsics once they are inlined into target functions
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/** Loads 16 weights sign-extended to 32-bit lanes */
+__attribute__((target("avx512f")))
+inline __m512i
+load16(const int8_t *weights)
+{
+  return _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *)weights));
+}
+
+__attribute__((target("avx512f")))
+inline __m512i
+load16(const int16_t *weights)
+{
+  return _mm512_cvtepi16_epi32(
+    _mm256_loadu_si256((const __m256i *)weights));
+}
+
+/** Stores 16 in-range 32-bit lanes back as weights */
+__attribute__((target("avx512f")))
+inline void
+store16(int8_t *weights, __m512i v)
+{
+  _mm_storeu_si128((__m128i *)weights, _mm512_cvtepi32_epi8(v));
+}
+
+__attribute__((target("avx512f")))
+inline void
+store16(int16_t *weights, __m512i v)
+{
+  _mm256_storeu_si256((__m256i *)weights, _mm512_cvtepi32_epi16(v));
+}
+
+template <class W>
+__attribute__((target("avx512f")))
+int
+dotAVX512(const W *weights, const uint64_t *history, unsigned n)
+{
+  __m512i acc0 = _mm512_setzero_si512();
+  __m512i acc1 = _mm512_setzero_si512();
+  unsigned i = 0;
+
+  for (; i + 32 <= n; i += 32) {
+    __mmask16 k0 = (history[i >> 6] >> (i & 63)) & 0xffff;
+    __mmask16 k1 = (history[i >> 6] >> ((i + 16) & 63)) & 0xffff;
+    __m512i w0 = load16(weights + i);
+    __m512i w1 = load16(weights + i + 16);
+    acc0 = _mm512_mask_add_epi32(acc0, k0, acc0, w0);
+    acc0 = _mm512_mask_sub_epi32(acc0, (__mmask16)~k0, acc0, w0);
+    acc1 = _mm512_mask_add_epi32(acc1, k1, acc1, w1);
+    acc1 = _mm512_mask_sub_epi32(acc1, (__mmask16)~k1, acc1, w1);
+  }
+
+  int lanes[16];
+  _mm512_storeu_si512(lanes, _mm512_add_epi32(acc0, acc1));
+  int sum = 0;
+  for (int l = 0; l < 16; l++) sum += lanes[l];
+  return sum + signedSum(weights, history, i, n);
+}
+
+template <class W>
+__attribute__((target("avx512f")))
+void
+trainAVX512(W *weights, const uint64_t *history, unsigned n, bool taken,
+            int min_weight, int max_weight)
+{
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i lo  = _mm512_set1_epi32(min_weight);
+  const __m512i hi  = _mm512_set1_epi32(max_weight);
+  unsigned i = 0;
+
+  for (; i + 16 <= n; i += 16) {
+    __mmask16 bits  = (history[i >> 6] >> (i & 63)) & 0xffff;
+    __mmask16 agree = taken ? bits : (__mmask16)~bits;
+    __m512i w = load16(weights + i);
+    w = _mm512_mask_add_epi32(w, agree, w, one);
+    w = _mm512_mask_sub_epi32(w, (__mmask16)~agree, w, one);
+    w = _mm512_min_epi32(_mm512_max_epi32(w, lo), hi);
+    store16(weights + i, w);
+  }
+  trainRange(weights, history, i, n, taken, min_weight, max_weight);
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+} // anonymous namespace
+
+const PerceptronKernel scalarPerceptronKernel = {
+  "scalar",
+  dotScalar<int8_t>, dotScalar<int16_t>,
+  trainScalar<int8_t>, trainScalar<int16_t>
+};
+
+#if defined(__x86_64__)
+const PerceptronKernel avx2PerceptronKernel = {
+  "avx2",
+  dotAVX2<int8_t>, dotAVX2<int16_t>,
+  trainAVX2<int8_t>, trainAVX2<int16_t>
+};
+
+const PerceptronKernel avx512PerceptronKernel = {
+  "avx512",
+  dotAVX512<int8_t>, dotAVX512<int16_t>,
+  trainAVX512<int8_t>, trainAVX512<int16_t>
+};
+#endif
+
+namespace
+{
+
+const PerceptronKernel &
+selectKernel()
+{
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return avx512PerceptronKernel;
+  if (__builtin_cpu_supports("avx2"))    return avx2PerceptronKernel;
+#endif
+  return scalarPerceptronKernel;
+}
+
+} // anonymous namespace
+
+const PerceptronKernel &
+perceptronKernel()
+{
+  static const PerceptronKernel &kernel = selectKernel();
+  return kernel;
+}
@@ -0,0 +1,85 @@
+/*****************************************************************
+ * File: perceptron_kernel.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Signed weighted sum and training kernels shared by
+ * the perceptron predictors, with scalar, AVX2 and AVX-512 versions
+ * selected at runtime: header file.
+ ****************************************************************/
+
+#ifndef __CPU_PRED_PERCEPTRON_KERNEL_HH__
+#define __CPU_PRED_PERCEPTRON_KERNEL_HH__
+
+#include <stdint.h>
+
+/**
+ * A set of perceptron kernels for one instruction set, for 8-bit and
+ * 16-bit weights. History bit i is bit (i % 64) of history[i / 64]; a
+ * set bit is a taken branch and stands for an input of +1, a clear bit
+ * for an input of -1. Sums are exact in 32 bits, so every version gives
+ * exactly the same results as the scalar one.
+ */
+struct PerceptronKernel
+{
+  /** Name of the instruction set, for reporting */
+  const char *name;
+
+  int (*dot8)(const int8_t *weights, const uint64_t *history, unsigned n);
+  int (*dot16)(const int16_t *weights, const uint64_t *history,
+               unsigned n);
+
+  void (*train8)(int8_t *weights, const uint64_t *history, unsigned n,
+                 bool taken, int min_weight, int max_weight);
+  void (*train16)(int16_t *weights, const uint64_t *history, unsigned n,
+                  bool taken, int min_weight, int max_weight);
+
+  /**
+   * Computes the sum of weights[i] * (history bit i ? +1 : -1).
+   * @param weights The n weights to be summed.
+   * @param history History bits, at least n of them.
+   * @param n Number of weights.
+   * @return The signed weighted sum.
+   */
+  int dot(const int8_t *weights, const uint64_t *history, unsigned n) const
+  { return dot8(weights, history, n); }
+
+  int dot(const int16_t *weights, const uint64_t *history, unsigned n) const
+  { return dot16(weights, history, n); }
+
+  /**
+   * Increments weights[i] when history bit i agrees with the outcome,
+   * and decrements it otherwise, saturating at the given bounds.
+   * @param weights The n weights to be trained.
+   * @param history History bits, at least n of them.
+   * @param n Number of weights.
+   * @param taken Outcome of the branch.
+   * @param min_weight Lowest value a weight may take.
+   * @param max_weight Highest value a weight may take.
+   */
+  void train(int8_t *weights, const uint64_t *history, unsigned n,
+             bool taken, int min_weight, int max_weight) const
+  { train8(weights, history, n, taken, min_weight, max_weight); }
+
+  void train(int16_t *weights, const uint64_t *history, unsigned n,
+             bool taken, int min_weight, int max_weight) const
+  { train16(weights, history, n, taken, min_weight, max_weight); }
+};
+
+/** Portable kernels, always available */
+extern const PerceptronKernel scalarPerceptronKernel;
+
+#if defined(__x86_64__)
+/** AVX2 kernels, only usable when the CPU supports AVX2 */
+extern const PerceptronKernel avx2PerceptronKernel;
+
+/** AVX-512 kernels, only usable when the CPU supports AVX-512F */
+extern const PerceptronKernel avx512PerceptronKernel;
+#endif
+
+/**
+ * Returns the widest kernels supported by the host CPU. The choice is
+ * made once, on first use.
+ */
+const PerceptronKernel &perceptronKernel();
+
+#endif
@@ -0,0 +1,145 @@
+/*****************************************************************
+ * File: perceptron_weights.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Table of narrow saturating perceptron weights shared
+ * by the neural predictors.
+ ****************************************************************/
+
+#ifndef __CPU_PRED_PERCEPTRON_WEIGHTS_HH__
+#define __CPU_PRED_PERCEPTRON_WEIGHTS_HH__
+
+#include <vector>
+
+#include "base/misc.hh"
+#include "cpu/pred/perceptron_kernel.hh"
+
+/**
+ * Perceptron weights as signed weightBits-bit saturating values, held
+ * in one flat rows x columns allocation of int8_t (up to 8 bits) or
+ * int16_t (up to 16 bits). Whole-row sums and training go through the
+ * perceptron kernels; single weights are read and trained in place.
+ */
+class PerceptronWeights
+{
+public:
+  PerceptronWeights()
+    : columns(0), weightBits(0), minWeight(0), maxWeight(0)
+  { }
+
+  /**
+   * Resizes the table and zeroes every weight.
+   * @param rows Number of perceptrons
+   * @param cols Number of weights per perceptron
+   * @param bits Width of a weight, between 2 and 16 bits
+   */
+  void assign(unsigned rows, unsigned cols, unsigned bits)
+  {
+    if (bits < 2 || bits > 16) {
+      fatal("Invalid perceptron weight width %u!\n", bits);
+    }
+    columns    = cols;
+    weightBits = bits;
+    maxWeight  = (1 << (bits - 1)) - 1;
+    minWeight  = -(maxWeight + 1);
+    narrowWeights.assign(wide() ? 0 : (size_t)rows * cols, 0);
+    wideWeights.assign(wide() ? (size_t)rows * cols : 0, 0);
+  }
+
+  /** Whether the weights are stored as int16_t rather than int8_t */
+  bool wide() const { return weightBits > 8; }
+
+  /** Width of a weight in bits */
+  unsigned bits() const { return weightBits; }
+
+  /** Returns a single weight */
+  int get(unsigned row, unsigned col) const
+  {
+    size_t i = (size_t)row * columns + col;
+    return wide() ? wideWeights[i] : narrowWeights[i];
+  }
+
+  /**
+   * Increments or decrements a single weight, saturating at the bounds
+   * of the weight width.
+   */
+  void train(unsigned row, unsigned col, bool inc)
+  {
+    size_t i = (size_t)row * columns + col;
+    if (wide()) wideWeights[i]   = saturate(wideWeights[i], inc);
+    else        narrowWeights[i] = saturate(narrowWeights[i], inc);
+  }
+
+  /**
+   * Signed sum of n consecutive weights of a row against history bits
+   * (see PerceptronKernel::dot).
+   */
+  int dot(const PerceptronKernel &kernel, unsigned row, unsigned col,
+          const uint64_t *history, unsigned n) const
+  {
+    size_t i = (size_t)row * columns + col;
+    if (wide()) return kernel.dot(&wideWeights[i], history, n);
+    return kernel.dot(&narrowWeights[i], history, n);
+  }
+
+  /**
+   * Trains n consecutive weights of a row against history bits (see
+   * PerceptronKernel::train).
+   */
+  void trainRow(const PerceptronKernel &kernel, unsigned row, unsigned col,
+                const uint64_t *history, unsigned n, bool taken)
+  {
+    size_t i = (size_t)row * columns + col;
+    if (wide()) {
+      kernel.train(&wideWeights[i], history, n, taken, minWeight,
+                   maxWeight);
+    } else {
+      kernel.train(&narrowWeights[i], history, n, taken, minWeight,
+                   maxWeight);
+    }
+  }
+
+  /**
+   * First weight of a row, W being the storage type of the table, i.e.
+   * int16_t if wide() and int8_t otherwise.
+   */
+  template <class W>
+  W *row(unsigned row)
+  { return storage((W *)0) + (size_t)row * columns; }
+
+  template <class W>
+  const W *row(unsigned row) const
+  { return const_cast<PerceptronWeights *>(this)->row<W>(row); }
+
+  /** Lowest value of a weight */
+  int minimum() const { return minWeight; }
+
+  /** Highest value of a weight */
+  int maximum() const { return maxWeight; }
+
+  /** Returns weight incremented or decremented within the bounds */
+  template <class W>
+  W saturate(W weight, bool inc) const
+  {
+    if      ( inc && weight < maxWeight) return weight + 1;
+    else if (!inc && weight > minWeight) return weight - 1;
+    return weight;
+  }
+
+private:
+  int8_t *storage(int8_t *) { return narrowWeights.data(); }
+  int16_t *storage(int16_t *) { return wideWeights.data(); }
+
+  unsigned columns;
+  unsigned weightBits;
+  int minWeight;
+  int maxWeight;
+
+  /** Storage when the weights fit in 8 bits */
+  std::vector<int8_t> narrowWeights;
+
+  /** Storage when the weights need up to 16 bits */
+  std::vector<int16_t> wideWeights;
+};
+
+#endif
@@ -0,0 +1,21 @@
+/*****************************************************************
+ * File: piecewise.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Piecewise-linear neural branch predictor, i.e. the
+ * neural path predictor with weights also selected by the address of
+ * the branch being predicted.
+ ****************************************************************/
+
+#include "cpu/pred/piecewise.hh"
+
+PiecewiseLinearBP::PiecewiseLinearBP(const PiecewiseLinearBPParams *params)
+  : NeuroPathBP(params, params->pcCount)
+{
+}
+
+PiecewiseLinearBP*
+PiecewiseLinearBPParams::create()
+{
+  return new PiecewiseLinearBP(this);
+}
@@ -0,0 +1,35 @@
+/*****************************************************************
+ * File: piecewise.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Piecewise-linear neural branch predictor, i.e. the
+ * neural path predictor with weights also selected by the address of
+ * the branch being predicted: header file.
+ ****************************************************************/
+
+#ifndef __CPU_PRED_PIECEWISE_PRED_HH__
+#define __CPU_PRED_PIECEWISE_PRED_HH__
+
+#include "cpu/pred/neuropath.hh"
+#include "params/PiecewiseLinearBP.hh"
+
+/**
+ * Piecewise-linear branch predictor, as in Jimenez's piecewise linear
+ * branch prediction paper: the weight of the branch i branches ago is
+ * selected by the address of the branch being predicted, the address
+ * of the branch i branches ago and i, so that each branch is predicted
+ * by several linear functions of the path leading to it. The address
+ * of the predicted branch picks one of pcCount weight sets, and the
+ * path-based predictor running totals are kept for every set, so that
+ * the prediction costs a single addition as with NeuroPathBP.
+ */
+class PiecewiseLinearBP : public NeuroPathBP
+{
+public:
+  /**
+   * Default branch predictor constructor.
+   */
+  PiecewiseLinearBP(const PiecewiseLinearBPParams *params);
+};
+
+#endif
@@ -11,7 +11,7 @@ import argparse
 import m5
 from m5.objects import *
 
-def simulate_BP(predictor, executable):
+def simulate_BP(predictor, executable, capture=None):
     """
     Given ints corresponding to the branch predictor to use in the gem5
     environment in addition to the executable to test on, runs the
@@ -20,6 +20,7 @@ def simulate_BP(predictor, executable):
     by the executable
     @param predictor The address of the branch to look up.
     @param bp_history Pointer to any bp history state.
+    @param capture File the predictor calls are captured to, if any
     @return void
     """
 
@@ -47,10 +48,17 @@ def simulate_BP(predictor, executable):
         LTAGE(),        # often best-performing current mainstream predictor
         AlwaysBP(),     # always true branch predictor (static)
         NeuroBP(),      # single perceptron neural branch predictor
-        NeuroPathBP()   # neural path branch predictor
+        NeuroPathBP(),  # neural path branch predictor
+        HashedPerceptronBP(), # hashed multi-table perceptron predictor
+        PiecewiseLinearBP()   # piecewise-linear neural path predictor
     ]
 
-    system.cpu.branchPred = branchPredictors[predictor]
+    branchPred = branchPredictors[predictor]
+    if capture is not None:
+        # the calls are passed on to the predictor and written out, to be
+        # played back through any predictor with replay/replay
+        branchPred = CaptureBP(predictor=branchPred, captureFile=capture)
+    system.cpu.branchPred = branchPred
     # ----------------------------------------------------------------------- #
 
     # Create a memory bus, a coherent crossbar, in this case
@@ -140,8 +148,14 @@ parser.add_argument('--exec', metavar='exec', type=int,
                     (4) StaticBP
                     (5) NeuralBP
                     (6) NeuralPathBP
+                    (7) HashedPerceptronBP
+                    (8) PiecewiseLinearBP
 """
 )
+parser.add_argument('--capture', metavar='file', default=None,
+                    help="""capture the calls made to the branch predictor
+                    into the given file, to be played back offline""")
 
 args = parser.parse_args()
-simulate_BP(predictor=vars(args)["pred"], executable=vars(args)["exec"])
+simulate_BP(predictor=vars(args)["pred"], executable=vars(args)["exec"],
+            capture=vars(args)["capture"])
@@ -0,0 +1,119 @@
+/*****************************************************************
+ * File: bench_kernel.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Microbenchmark of the perceptron kernels. Checks that
+ * every instruction set supported by the host gives the same sums and
+ * trained weights as the scalar kernels, and reports the time per call
+ * and the speedup over scalar for a range of history lengths and both
+ * weight widths.
+ ****************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "cpu/pred/perceptron_kernel.hh"
+
+namespace
+{
+
+/** Time per call of fn, in nanoseconds, over enough calls to be stable */
+template <class Fn>
+double
+timeCalls(unsigned n, Fn fn)
+{
+  unsigned calls = (1u << 26) / n + 1;
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned c = 0; c < calls; c++) fn(c);
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return 1e9 * elapsed.count() / calls;
+}
+
+/**
+ * Checks and times every kernel for one weight type, returning the
+ * number of kernels disagreeing with the scalar ones.
+ */
+template <class W>
+int
+benchWidth(const std::vector<const PerceptronKernel *> &kernels,
+           unsigned bits, std::mt19937_64 &rng)
+{
+  const int max_weight = (1 << (bits - 1)) - 1;
+  const int min_weight = -(max_weight + 1);
+  const unsigned sizes[] = { 31, 64, 256, 1024, 8192 };
+  int failures = 0;
+
+  for (unsigned n : sizes) {
+    std::vector<uint64_t> history((n + 63) / 64);
+    for (uint64_t &word : history) word = rng();
+    // includes weights at both bounds to exercise saturation
+    std::vector<W> weights(n);
+    for (W &w : weights) {
+      w = (W)(min_weight + (int)(rng() % (max_weight - min_weight + 1)));
+    }
+
+    // reference results from the scalar kernels
+    int expected = scalarPerceptronKernel.dot(weights.data(),
+                                              history.data(), n);
+    std::vector<W> trained(weights);
+    for (int round = 0; round < 4; round++) {
+      scalarPerceptronKernel.train(trained.data(), history.data(), n,
+                                   round & 1, min_weight, max_weight);
+    }
+
+    double scalar_ns = 0;
+    for (const PerceptronKernel *kernel : kernels) {
+      std::vector<W> check(weights);
+      for (int round = 0; round < 4; round++) {
+        kernel->train(check.data(), history.data(), n, round & 1,
+                      min_weight, max_weight);
+      }
+      bool ok = kernel->dot(weights.data(), history.data(), n) == expected &&
+                check == trained;
+      if (!ok) failures++;
+
+      volatile int sink = 0;
+      double dot_ns = timeCalls(n, [&](unsigned) {
+        sink = sink + kernel->dot(weights.data(), history.data(), n);
+      });
+      std::vector<W> scratch(weights);
+      double train_ns = timeCalls(n, [&](unsigned c) {
+        kernel->train(scratch.data(), history.data(), n, c & 1,
+                      min_weight, max_weight);
+      });
+      if (kernel == &scalarPerceptronKernel) scalar_ns = dot_ns;
+
+      std::printf("bits=%-2u n=%-5u %-7s dot %9.1f ns  train %9.1f ns  "
+                  "dot speedup %5.2fx  %s\n", bits, n, kernel->name,
+                  dot_ns, train_ns, scalar_ns / dot_ns,
+                  ok ? "ok" : "MISMATCH");
+    }
+  }
+  return failures;
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+  std::vector<const PerceptronKernel *> kernels;
+  kernels.push_back(&scalarPerceptronKernel);
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))    kernels.push_back(&avx2PerceptronKernel);
+  if (__builtin_cpu_supports("avx512f")) kernels.push_back(&avx512PerceptronKernel);
+#endif
+  std::printf("selected kernel : %s\n", perceptronKernel().name);
+
+  std::mt19937_64 rng(1);
+  int failures = 0;
+  failures += benchWidth<int8_t>(kernels, 6, rng);
+  failures += benchWidth<int8_t>(kernels, 8, rng);
+  failures += benchWidth<int16_t>(kernels, 16, rng);
+  return failures ? 1 : 0;
+}
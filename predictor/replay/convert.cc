@@ -0,0 +1,46 @@
+/*****************************************************************
+ * File: convert.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Converts the 14-column text dumps of static/data into
+ * the compact binary branch trace format read by the replay engine.
+ * Only the branch rows are kept, so the conversion is done once and
+ * every later replay skips the string parsing.
+ ****************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "trace.hh"
+
+int
+main(int argc, char **argv)
+{
+  if (argc != 3) {
+    std::fprintf(stderr,
+      "usage: %s input.trace output.bt\n"
+      "  input.trace may be - to read the text dump from stdin\n",
+      argv[0]);
+    return 1;
+  }
+
+  TextTraceReader reader(argv[1]);
+  BinaryTraceWriter writer(argv[2]);
+
+  BranchRecord rec;
+  uint64_t counts[5] = { 0, 0, 0, 0, 0 };
+  while (reader.next(rec)) {
+    writer.write(rec);
+    counts[rec.kind]++;
+  }
+  writer.close();
+
+  std::printf("instructions : %llu\n",
+              (unsigned long long)reader.instructions());
+  std::printf("branches : %llu\n", (unsigned long long)writer.records());
+  for (int kind = BranchCond; kind <= BranchIndirect; kind++) {
+    std::printf("%s : %llu\n", branchKindName((BranchKind)kind),
+                (unsigned long long)counts[kind]);
+  }
+  return 0;
+}
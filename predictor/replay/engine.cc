@@ -0,0 +1,379 @@
+/*****************************************************************
+ * File: engine.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Trace-driven replay engine feeding a recorded branch
+ * stream straight into a BPredUnit, bypassing the gem5 CPU models.
+ ****************************************************************/
+
+#include "engine.hh"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+#include "base/misc.hh"
+#include "cpu/pred/always.hh"
+#include "cpu/pred/hashed_perceptron.hh"
+#include "cpu/pred/neurobranch.hh"
+#include "cpu/pred/neuropath.hh"
+#include "cpu/pred/piecewise.hh"
+
+BPredUnit *
+createPredictor(const ReplayConfig &config)
+{
+  if (config.predictor == "NeuroBP") {
+    NeuroBPParams params;
+    params.numThreads          = config.numThreads;
+    params.globalPredictorSize = config.globalPredictorSize;
+    params.weightBits          = config.weightBits;
+    params.adaptiveTheta       = config.adaptiveTheta;
+    params.thetaPerPerceptron  = config.thetaPerPerceptron;
+    if (config.perceptronCount)
+      params.perceptronCount   = config.perceptronCount;
+    return params.create();
+  } else if (config.predictor == "NeuroPathBP") {
+    NeuroPathBPParams params;
+    params.numThreads          = config.numThreads;
+    params.globalPredictorSize = config.globalPredictorSize;
+    params.weightBits          = config.weightBits;
+    params.adaptiveTheta       = config.adaptiveTheta;
+    params.thetaPerPerceptron  = config.thetaPerPerceptron;
+    if (config.perceptronCount)
+      params.perceptronCount   = config.perceptronCount;
+    return params.create();
+  } else if (config.predictor == "PiecewiseLinearBP") {
+    PiecewiseLinearBPParams params;
+    params.numThreads          = config.numThreads;
+    params.globalPredictorSize = config.globalPredictorSize;
+    params.weightBits          = config.weightBits;
+    params.adaptiveTheta       = config.adaptiveTheta;
+    params.thetaPerPerceptron  = config.thetaPerPerceptron;
+    if (config.perceptronCount)
+      params.perceptronCount   = config.perceptronCount;
+    if (config.pcCount) params.pcCount = config.pcCount;
+    return params.create();
+  } else if (config.predictor == "HashedPerceptronBP") {
+    HashedPerceptronBPParams params;
+    params.numThreads          = config.numThreads;
+    params.globalPredictorSize = config.globalPredictorSize;
+    params.weightBits          = config.weightBits;
+    params.adaptiveTheta       = config.adaptiveTheta;
+    params.thetaPerPerceptron  = config.thetaPerPerceptron;
+    if (config.numTables) params.numTables = config.numTables;
+    if (config.tableSize) params.tableSize = config.tableSize;
+    return params.create();
+  } else if (config.predictor == "AlwaysBP") {
+    AlwaysBPParams params;
+    params.numThreads = config.numThreads;
+    return params.create();
+  }
+  fatal("Unknown predictor %s\n", config.predictor.c_str());
+}
+
+void
+ReplayStats::merge(const ReplayStats &other)
+{
+  instructions  += other.instructions;
+  branches      += other.branches;
+  condBranches  += other.condBranches;
+  condIncorrect += other.condIncorrect;
+  trained       += other.trained;
+  seconds       += other.seconds;
+  cached        = cached || other.cached;
+}
+
+double
+ReplayStats::mpki() const
+{
+  if (instructions == 0) return 0;
+  return 1000.0 * condIncorrect / instructions;
+}
+
+double
+ReplayStats::accuracy() const
+{
+  if (condBranches == 0) return 0;
+  return 1.0 - (double)condIncorrect / condBranches;
+}
+
+double
+ReplayStats::nsPerBranch() const
+{
+  if (branches == 0) return 0;
+  return 1e9 * seconds / branches;
+}
+
+ReplayEngine::ReplayEngine(BPredUnit *bp, ThreadID tid)
+  : bp(bp), tid(tid)
+{ }
+
+void
+ReplayEngine::replay(const BranchRecord &rec, ReplayStats &stats)
+{
+  void *bp_history = NULL;
+  bool prediction;
+  const uint64_t trained = bp->trainedBranches();
+
+  if (rec.kind == BranchCond) {
+    prediction = bp->lookup(tid, rec.pc, bp_history);
+  } else {
+    bp->uncondBranch(tid, rec.pc, bp_history);
+    prediction = true;
+  }
+
+  // a misprediction is corrected right away, as the CPU squashes
+  // before the branch commits
+  if (prediction != rec.taken) {
+    bp->update(tid, rec.pc, rec.taken, bp_history, true);
+  }
+  bp->update(tid, rec.pc, rec.taken, bp_history, false);
+
+  stats.instructions += rec.instGap;
+  stats.branches++;
+  stats.trained += bp->trainedBranches() - trained;
+  if (rec.kind == BranchCond) {
+    stats.condBranches++;
+    if (prediction != rec.taken) stats.condIncorrect++;
+  }
+}
+
+std::vector<ReplayChunk>
+splitTrace(uint64_t records, unsigned chunks, uint64_t warmup)
+{
+  if (chunks == 0) chunks = 1;
+
+  std::vector<ReplayChunk> split(chunks);
+  for (unsigned k = 0; k < chunks; k++) {
+    split[k].first       = records * k / chunks;
+    split[k].last        = records * (k + 1) / chunks;
+    split[k].warmupFirst = split[k].first > warmup
+                           ? split[k].first - warmup : 0;
+  }
+  return split;
+}
+
+void
+replayChunk(const ReplayConfig &config, const MappedTrace &trace,
+            const ReplayChunk &chunk, ReplayStats &stats)
+{
+  std::unique_ptr<BPredUnit> bp(createPredictor(config));
+  ReplayEngine engine(bp.get());
+
+  // the warmup trains the predictor and fills its history, but is not
+  // counted
+  ReplayStats warmup;
+  BinaryTraceReader warmup_reader(trace, chunk.warmupFirst, chunk.first);
+  engine.replayAll(warmup_reader, warmup);
+
+  BinaryTraceReader reader(trace, chunk.first, chunk.last);
+  engine.replayAll(reader, stats);
+}
+
+void
+replaySampled(const ReplayConfig &config, const MappedTrace &trace,
+              const ReplaySampling &sampling,
+              std::vector<ReplayStats> &windows)
+{
+  if (sampling.window == 0 || sampling.window > sampling.period) {
+    fatal("Invalid sampling window!\n");
+  }
+
+  std::unique_ptr<BPredUnit> bp(createPredictor(config));
+  ReplayEngine engine(bp.get());
+
+  // only whole periods are sampled, each window closing its period
+  ReplayStats warmup;
+  for (uint64_t start = 0; trace.records() - start >= sampling.period;
+       start += sampling.period) {
+    const uint64_t first = start + sampling.period - sampling.window;
+    const uint64_t warmup_first =
+      first - std::min(sampling.warmup, first - start);
+
+    BinaryTraceReader warmup_reader(trace, warmup_first, first);
+    engine.replayAll(warmup_reader, warmup);
+
+    windows.push_back(ReplayStats());
+    BinaryTraceReader reader(trace, first, first + sampling.window);
+    engine.replayAll(reader, windows.back());
+  }
+}
+
+namespace
+{
+
+/** Two-sided standard normal quantile of the given confidence level */
+double
+normalQuantile(double confidence)
+{
+  // bisection of erf(z / sqrt(2)) = confidence
+  double low = 0, high = 10;
+  for (int i = 0; i < 100; i++) {
+    const double z = (low + high) / 2;
+    if (std::erf(z / std::sqrt(2.0)) < confidence) {
+      low = z;
+    } else {
+      high = z;
+    }
+  }
+  return (low + high) / 2;
+}
+
+} // anonymous namespace
+
+MpkiEstimate
+estimateMpki(const std::vector<ReplayStats> &windows, double confidence)
+{
+  ReplayStats total;
+  for (size_t i = 0; i < windows.size(); i++) total.merge(windows[i]);
+
+  MpkiEstimate estimate;
+  estimate.windows   = windows.size();
+  estimate.mpki      = total.mpki();
+  estimate.halfWidth = 0;
+  estimate.variation = 0;
+  if (windows.size() < 2 || total.instructions == 0) return estimate;
+
+  // variance of the ratio estimate, from the residuals of the windows
+  // around it
+  const double n = windows.size();
+  const double mean_instructions = total.instructions / n;
+  double squares = 0;
+  for (size_t i = 0; i < windows.size(); i++) {
+    const double residual = 1000.0 * windows[i].condIncorrect -
+      estimate.mpki * windows[i].instructions;
+    squares += residual * residual;
+  }
+  const double deviation = std::sqrt(squares / (n - 1)) / mean_instructions;
+
+  estimate.halfWidth = normalQuantile(confidence) * deviation / std::sqrt(n);
+  if (estimate.mpki > 0) estimate.variation = deviation / estimate.mpki;
+  return estimate;
+}
+
+uint64_t
+windowsNeeded(const MpkiEstimate &estimate, double confidence, double error)
+{
+  const double windows = normalQuantile(confidence) * estimate.variation /
+    error;
+  return (uint64_t)std::ceil(windows * windows);
+}
+
+ReplayResultCache::ReplayResultCache(const std::string &dir,
+                                     const std::string &sources)
+  : cache(dir), sources(sources)
+{
+  char binary[PATH_MAX];
+  const ssize_t length = readlink("/proc/self/exe", binary,
+                                  sizeof(binary) - 1);
+  struct stat info;
+  if (length <= 0) fatal("Cannot find the running binary\n");
+  binary[length] = '\0';
+  if (stat(binary, &info) != 0) fatal("Cannot stat %s\n", binary);
+  binaryTime = info.st_mtime;
+
+  if (this->sources.empty()) {
+    std::string path(binary);
+    this->sources = path.substr(0, path.rfind('/')) + "/..";
+  }
+}
+
+std::string
+ReplayResultCache::key(const ReplayConfig &config, const std::string &trace)
+{
+  std::string &source_digest = sourceDigests[config.predictor];
+  if (source_digest.empty()) {
+    // the predictor itself, then the engine and the shim it is built
+    // against, which holds the parameter defaults
+    ContentHash hash;
+    time_t newest = 0;
+    hashPredictorSources(hash, sources, config.predictor, newest);
+    const std::string engine[] = {
+      "replay/engine.cc", "replay/engine.hh", "replay/trace.cc",
+      "replay/trace.hh", "replay/shim/cpu/pred/bpred_unit.hh",
+      "replay/shim/params/" + config.predictor + ".hh"
+    };
+    for (size_t i = 0; i < sizeof(engine) / sizeof(engine[0]); i++) {
+      time_t mtime;
+      hash.add(engine[i]);
+      if (hash.addFile(sources + "/" + engine[i], &mtime)) {
+        newest = std::max(newest, mtime);
+      }
+    }
+    if (newest > binaryTime) {
+      fatal("The sources of %s in %s are newer than the binary, rebuild "
+            "it\n", config.predictor.c_str(), sources.c_str());
+    }
+    source_digest = hash.digest();
+  }
+
+  std::string &trace_digest = traceDigests[trace];
+  if (trace_digest.empty()) {
+    ContentHash hash;
+    if (!hash.addFile(trace)) fatal("Could not open trace %s\n",
+                                    trace.c_str());
+    trace_digest = hash.digest();
+  }
+
+  ContentHash hash;
+  hash.add(std::string("replay 1")).add(source_digest).add(trace_digest);
+  hash.add(config.predictor);
+  const uint64_t parameters[] = {
+    config.globalPredictorSize, config.weightBits, config.perceptronCount,
+    config.numTables, config.tableSize, config.pcCount,
+    config.adaptiveTheta, config.thetaPerPerceptron, config.numThreads
+  };
+  hash.add(parameters, sizeof(parameters));
+  return hash.digest();
+}
+
+bool
+ReplayResultCache::lookup(const std::string &key, ReplayStats &stats) const
+{
+  std::string value;
+  if (!cache.lookup(key, value)) return false;
+
+  // seconds stays 0, this replay never having run; the time stored
+  // along with the counts by earlier versions is ignored, and their
+  // entries without a trained count are missed
+  unsigned long long instructions, branches, cond_branches, cond_incorrect;
+  unsigned long long trained;
+  if (std::sscanf(value.c_str(),
+                  "instructions : %llu\nbranches : %llu\n"
+                  "condBranches : %llu\ncondIncorrect : %llu\n"
+                  "trained : %llu\n",
+                  &instructions, &branches, &cond_branches,
+                  &cond_incorrect, &trained) != 5) {
+    return false;
+  }
+  stats.instructions  = instructions;
+  stats.branches      = branches;
+  stats.condBranches  = cond_branches;
+  stats.condIncorrect = cond_incorrect;
+  stats.trained       = trained;
+  stats.seconds       = 0;
+  stats.cached        = true;
+  return true;
+}
+
+void
+ReplayResultCache::store(const std::string &key,
+                         const ReplayStats &stats) const
+{
+  char value[256];
+  std::snprintf(value, sizeof(value),
+                "instructions : %llu\nbranches : %llu\n"
+                "condBranches : %llu\ncondIncorrect : %llu\n"
+                "trained : %llu\n",
+                (unsigned long long)stats.instructions,
+                (unsigned long long)stats.branches,
+                (unsigned long long)stats.condBranches,
+                (unsigned long long)stats.condIncorrect,
+                (unsigned long long)stats.trained);
+  cache.store(key, value);
+}
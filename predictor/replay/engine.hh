@@ -0,0 +1,315 @@
+/*****************************************************************
+ * File: engine.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Trace-driven replay engine feeding a recorded branch
+ * stream straight into a BPredUnit, bypassing the gem5 CPU models:
+ * header file.
+ ****************************************************************/
+
+#ifndef __REPLAY_ENGINE_HH__
+#define __REPLAY_ENGINE_HH__
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "cpu/pred/bpred_unit.hh"
+#include "result_cache.hh"
+#include "trace.hh"
+
+/** Parameters selecting and sizing the predictor to be replayed */
+struct ReplayConfig
+{
+  ReplayConfig()
+    : predictor("NeuroBP"), globalPredictorSize(8192), weightBits(8),
+      perceptronCount(0), numTables(0), tableSize(0), pcCount(0),
+      adaptiveTheta(false),
+      thetaPerPerceptron(false), numThreads(1)
+  { }
+
+  /** Predictor name, as listed in predictor/settings.py */
+  std::string predictor;
+
+  /** globalPredictorSize parameter of the neural predictors */
+  unsigned globalPredictorSize;
+
+  /** weightBits parameter of the neural predictors */
+  unsigned weightBits;
+
+  /** perceptronCount parameter of the neural predictors, 0 keeping the
+   *  default of the predictor */
+  unsigned perceptronCount;
+
+  /** numTables and tableSize parameters of HashedPerceptronBP, 0
+   *  keeping the defaults */
+  unsigned numTables;
+  unsigned tableSize;
+
+  /** pcCount parameter of PiecewiseLinearBP, 0 keeping the default */
+  unsigned pcCount;
+
+  /** adaptiveTheta and thetaPerPerceptron parameters of the neural
+   *  predictors */
+  bool adaptiveTheta;
+  bool thetaPerPerceptron;
+
+  /** numThreads parameter of BranchPredictor */
+  unsigned numThreads;
+};
+
+/**
+ * Builds the predictor described by the given configuration, exiting
+ * if the name is unknown. The caller owns the returned predictor.
+ */
+BPredUnit *createPredictor(const ReplayConfig &config);
+
+/** Outcome counts accumulated over a replay */
+struct ReplayStats
+{
+  ReplayStats()
+    : instructions(0), branches(0), condBranches(0), condIncorrect(0),
+      trained(0), seconds(0), cached(false)
+  { }
+
+  /** Adds the counts of other into these ones */
+  void merge(const ReplayStats &other);
+
+  /** Conditional mispredictions per thousand instructions */
+  double mpki() const;
+
+  /** Fraction of conditional branches predicted correctly */
+  double accuracy() const;
+
+  /** Predictor time spent per branch, in nanoseconds */
+  double nsPerBranch() const;
+
+  uint64_t instructions;
+  uint64_t branches;
+  uint64_t condBranches;
+  uint64_t condIncorrect;
+
+  /** Training passes of the predictor (see trainedBranches()) */
+  uint64_t trained;
+
+  /** Wall-clock time spent inside the predictor, in seconds */
+  double seconds;
+
+  /**
+   * Whether some of the counts were looked up in a result cache rather
+   * than replayed, seconds then leaving their replay out
+   */
+  bool cached;
+};
+
+/**
+ * Drives a predictor the way BPredUnit::predict/squash/update do for an
+ * in-order CPU: every branch is predicted (lookup for conditional ones,
+ * uncondBranch otherwise), a mispredicted branch is corrected with a
+ * squashing update, and the branch is then committed with a regular
+ * update. There is no BTB, RAS or indirect target prediction.
+ */
+class ReplayEngine
+{
+public:
+  /**
+   * @param bp Predictor to drive; not owned by the engine.
+   * @param tid Hardware thread the stream is replayed on.
+   */
+  ReplayEngine(BPredUnit *bp, ThreadID tid = 0);
+
+  /**
+   * Predicts and commits a single branch.
+   * @param rec The branch to be replayed.
+   * @param stats Counts to be updated with the outcome.
+   */
+  void replay(const BranchRecord &rec, ReplayStats &stats);
+
+  /**
+   * Replays every remaining branch of the given reader. Records are
+   * read in batches so that only predictor time is measured.
+   * @param reader Any reader providing bool next(BranchRecord &).
+   * @param stats Counts to be updated with the outcomes.
+   */
+  template <class Reader>
+  void replayAll(Reader &reader, ReplayStats &stats);
+
+private:
+  /** Number of records decoded per timed batch */
+  static const size_t batchSize = 4096;
+
+  BPredUnit *bp;
+  ThreadID tid;
+
+  /** Reused batch of decoded records */
+  std::vector<BranchRecord> batch;
+};
+
+/**
+ * Record range of one chunk of a trace replayed in independent chunks:
+ * the chunk covers [first, last), and its predictor is first warmed up
+ * on [warmupFirst, first), the end of the previous chunk, so that it
+ * does not start cold.
+ */
+struct ReplayChunk
+{
+  uint64_t warmupFirst;
+  uint64_t first;
+  uint64_t last;
+};
+
+/**
+ * Splits a trace into chunks of (nearly) equal length.
+ * @param records Number of records of the trace.
+ * @param chunks Number of chunks, at least 1.
+ * @param warmup Number of records each chunk is warmed up on, fewer
+ * for the chunks near the start of the trace.
+ */
+std::vector<ReplayChunk> splitTrace(uint64_t records, unsigned chunks,
+                                    uint64_t warmup);
+
+/**
+ * Replays a chunk of a binary trace on a predictor of its own, after
+ * warming it up. Only the branches of the chunk itself are counted, so
+ * that the stats of all the chunks merge into those of the trace; they
+ * differ from a sequential replay by whatever the warmup did not
+ * recover of the predictor state at the start of the chunk.
+ * @param config Predictor to be built for the chunk.
+ * @param trace The mapped trace.
+ * @param chunk Records to be replayed.
+ * @param stats Counts to be updated with the outcomes of the chunk.
+ */
+void replayChunk(const ReplayConfig &config, const MappedTrace &trace,
+                 const ReplayChunk &chunk, ReplayStats &stats);
+
+/**
+ * Periodic (SMARTS-style) sampling of a trace. The trace is cut into
+ * periods of period records; in every period, the predictor is
+ * functionally warmed up on the warmup records preceding the last
+ * window records of the period, i.e. predicted and trained without
+ * being counted, and then measured on these window records, the rest of
+ * the period being skipped. A warmup as long as the period keeps the
+ * predictor warm throughout, skipping nothing.
+ */
+struct ReplaySampling
+{
+  ReplaySampling() : period(0), window(10000), warmup(90000) { }
+
+  uint64_t period;
+  uint64_t window;
+  uint64_t warmup;
+};
+
+/**
+ * Replays the sampled windows of a binary trace on a single predictor,
+ * which keeps its state across the skipped records.
+ * @param config Predictor to be built.
+ * @param trace The mapped trace.
+ * @param sampling Sampling period, window and warmup.
+ * @param windows Counts of every measured window, in trace order.
+ */
+void replaySampled(const ReplayConfig &config, const MappedTrace &trace,
+                   const ReplaySampling &sampling,
+                   std::vector<ReplayStats> &windows);
+
+/** MPKI of a trace estimated from sampled windows */
+struct MpkiEstimate
+{
+  /** Number of windows measured */
+  size_t windows;
+
+  /** Mispredictions per thousand instructions over all the windows */
+  double mpki;
+
+  /** Half width of the confidence interval around mpki */
+  double halfWidth;
+
+  /**
+   * Coefficient of variation of the windows around mpki, from which
+   * the number of windows needed for a given interval follows.
+   */
+  double variation;
+};
+
+/**
+ * Estimates the MPKI of a trace from its sampled windows (a ratio
+ * estimate, windows differing in instruction count) along with its
+ * confidence interval, assuming the windows are many enough for their
+ * mean to be normally distributed.
+ * @param windows Counts of the windows, at least 2.
+ * @param confidence Confidence level of the interval, e.g. 0.997.
+ */
+MpkiEstimate estimateMpki(const std::vector<ReplayStats> &windows,
+                          double confidence);
+
+/**
+ * Number of windows needed for a confidence interval of +-error (a
+ * fraction of the MPKI) at the given confidence level, given the
+ * variation of the windows of an estimate.
+ */
+uint64_t windowsNeeded(const MpkiEstimate &estimate, double confidence,
+                       double error);
+
+/**
+ * Cache of the results of whole replays (see ResultCache), keyed by the
+ * sources of the predictor and of the engine, the configuration and the
+ * contents of the trace, so that only the replays some change affects
+ * are redone. Keys are computed, and results looked up and stored, from
+ * a single thread.
+ */
+class ReplayResultCache
+{
+public:
+  /**
+   * @param dir Directory of the cache.
+   * @param sources Predictor directory the sources are hashed from,
+   * empty for the parent directory of the running binary (replay/..).
+   * Exits if the binary is older than any of them, its results not
+   * being those of the sources.
+   */
+  ReplayResultCache(const std::string &dir, const std::string &sources);
+
+  /** Key of the replay of a trace with the given configuration */
+  std::string key(const ReplayConfig &config, const std::string &trace);
+
+  /** Looks up the counts of a replay, returning whether they were found */
+  bool lookup(const std::string &key, ReplayStats &stats) const;
+
+  /** Stores the counts of a replay */
+  void store(const std::string &key, const ReplayStats &stats) const;
+
+private:
+  ResultCache cache;
+  std::string sources;
+
+  /** Modification time of the running binary */
+  time_t binaryTime;
+
+  /** Digests of the sources of each predictor, and of each trace */
+  std::map<std::string, std::string> sourceDigests;
+  std::map<std::string, std::string> traceDigests;
+};
+
+template <class Reader>
+void
+ReplayEngine::replayAll(Reader &reader, ReplayStats &stats)
+{
+  batch.resize(batchSize);
+  for (;;) {
+    size_t n = 0;
+    while (n < batchSize && reader.next(batch[n])) n++;
+    if (n == 0) break;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+      replay(batch[i], stats);
+    }
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    stats.seconds += elapsed.count();
+  }
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*****************************************************************
+ * File: lockstep.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Replay of one branch stream through several NeuroBP
+ * configurations at once, sharing the trace decoding and the global
+ * history between them.
+ ****************************************************************/
+
+#include "lockstep.hh"
+
+#include <algorithm>
+#include <stdlib.h>
+
+#include "base/intmath.hh"
+#include "base/misc.hh"
+#include "params/NeuroBP.hh"
+
+LockstepNeuroBP::LockstepNeuroBP(const std::vector<ReplayConfig> &configs)
+  : kernel(perceptronKernel()), maxHistorySize(0), theta(configs.size()),
+    weightsTable(configs.size()), laneStats(configs.size())
+{
+  const NeuroBPParams defaults;
+  for (size_t lane = 0; lane < configs.size(); lane++) {
+    const ReplayConfig &config = configs[lane];
+    if (config.predictor != "NeuroBP") {
+      fatal("Only NeuroBP can be replayed in lockstep, not %s\n",
+            config.predictor.c_str());
+    }
+
+    // the same checks and setup as NeuroBP
+    const unsigned size  = config.globalPredictorSize;
+    const unsigned count = config.perceptronCount ? config.perceptronCount
+                                                  : defaults.perceptronCount;
+    if (!isPowerOf2(size)) {
+      fatal("Invalid global predictor size!\n");
+    }
+    if (count == 0) {
+      fatal("Invalid perceptron count!\n");
+    }
+
+    historySize.push_back(size);
+    perceptronCount.push_back(count);
+    theta[lane].init(1.93 * size + 14, count, config.adaptiveTheta,
+                     config.thetaPerPerceptron);
+    weightsTable[lane].assign(count, size + 1, config.weightBits);
+    maxHistorySize = std::max(maxHistorySize, size);
+  }
+
+  globalHistoryWords.assign(HistoryRegister::storageWords(maxHistorySize),
+                            0);
+  globalHistory.attach(globalHistoryWords.data(), maxHistorySize);
+  historyBits.assign((maxHistorySize + 63) / 64, 0);
+}
+
+void
+LockstepNeuroBP::replay(const BranchRecord &rec)
+{
+  if (rec.kind == BranchCond) {
+    globalHistory.read(globalHistory.checkpoint(), historyBits.data(),
+                       maxHistorySize);
+
+    for (unsigned lane = 0; lane < lanes(); lane++) {
+      const unsigned size = historySize[lane];
+      const unsigned row  = rec.pc % perceptronCount[lane];
+      PerceptronWeights &weights = weightsTable[lane];
+
+      int y_out = weights.get(row, 0) +
+        weights.dot(kernel, row, 1, historyBits.data(), size);
+      bool prediction = (y_out >= 0);
+
+      ReplayStats &stats = laneStats[lane];
+      stats.condBranches++;
+
+      // train as NeuroBP does when the branch commits
+      bool train = false;
+      if (prediction != rec.taken) {
+        stats.condIncorrect++;
+        theta[lane].mispredicted(row);
+        train = true;
+      } else if ((unsigned)abs(y_out) <= theta[lane][row]) {
+        theta[lane].weaklyCorrect(row);
+        train = true;
+      }
+
+      if (train) {
+        stats.trained++;
+        weights.train(row, 0, rec.taken);
+        weights.trainRow(kernel, row, 1, historyBits.data(),
+                         size - 1, rec.taken);
+      }
+    }
+  }
+
+  // whether predicted or not, the history ends up with the outcome
+  globalHistory.push(rec.taken);
+
+  for (unsigned lane = 0; lane < lanes(); lane++) {
+    laneStats[lane].instructions += rec.instGap;
+    laneStats[lane].branches++;
+  }
+}
@@ -0,0 +1,126 @@
+/*****************************************************************
+ * File: lockstep.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Replay of one branch stream through several NeuroBP
+ * configurations at once, sharing the trace decoding and the global
+ * history between them: header file.
+ ****************************************************************/
+
+#ifndef __REPLAY_LOCKSTEP_HH__
+#define __REPLAY_LOCKSTEP_HH__
+
+#include <vector>
+
+#include "cpu/pred/history_register.hh"
+#include "cpu/pred/perceptron_kernel.hh"
+#include "cpu/pred/perceptron_weights.hh"
+#include "cpu/pred/training_threshold.hh"
+#include "engine.hh"
+#include "trace.hh"
+
+/**
+ * Several NeuroBP configurations (lanes) replayed in lockstep over a
+ * single pass of a branch stream. When replayed through ReplayEngine, a
+ * NeuroBP global history holds the actual outcomes of the previous
+ * branches whenever a branch is looked up (a mispredicted one being
+ * squashed before the next lookup), whatever the configuration, so the
+ * lanes share one history register, read once per branch up to the
+ * longest history of any lane, and the record is decoded once. Each
+ * lane then only computes and trains its own perceptron, exactly as
+ * NeuroBP does, so that the outcome counts of a lane are those of a
+ * separate replay of its configuration.
+ *
+ * The lane parameters are kept as structure of arrays, the loop over the
+ * lanes touching only what it needs of each. Lanes may differ in history
+ * length, perceptron count, weight width and threshold.
+ */
+class LockstepNeuroBP
+{
+public:
+  /**
+   * @param configs NeuroBP configurations, one per lane
+   */
+  LockstepNeuroBP(const std::vector<ReplayConfig> &configs);
+
+  /** Predicts and commits a single branch in every lane */
+  void replay(const BranchRecord &rec);
+
+  /**
+   * Replays every remaining branch of the given reader. The time spent
+   * predicting is shared evenly between the lanes.
+   * @param reader Any reader providing bool next(BranchRecord &).
+   */
+  template <class Reader>
+  void replayAll(Reader &reader);
+
+  /** Number of lanes */
+  unsigned lanes() const { return historySize.size(); }
+
+  /** Outcome counts of a lane */
+  const ReplayStats &stats(unsigned lane) const { return laneStats[lane]; }
+
+private:
+  /** Number of records decoded per timed batch */
+  static const size_t batchSize = 4096;
+
+  /** Weighted sum/training kernels for the host instruction set */
+  const PerceptronKernel &kernel;
+
+  /** Longest history of any lane */
+  unsigned maxHistorySize;
+
+  /** Global history of actual outcomes, shared by the lanes */
+  HistoryRegister globalHistory;
+
+  /** Storage of globalHistory */
+  std::vector<uint64_t> globalHistoryWords;
+
+  /** History bits of the current branch, maxHistorySize of them */
+  std::vector<uint64_t> historyBits;
+
+  /** globalPredictorSize of each lane */
+  std::vector<unsigned> historySize;
+
+  /** perceptronCount of each lane */
+  std::vector<unsigned> perceptronCount;
+
+  /** Training threshold of each lane */
+  std::vector<TrainingThreshold> theta;
+
+  /** Perceptron weights of each lane */
+  std::vector<PerceptronWeights> weightsTable;
+
+  /** Outcome counts of each lane */
+  std::vector<ReplayStats> laneStats;
+
+  /** Reused batch of decoded records */
+  std::vector<BranchRecord> batch;
+};
+
+template <class Reader>
+void
+LockstepNeuroBP::replayAll(Reader &reader)
+{
+  double seconds = 0;
+  batch.resize(batchSize);
+  for (;;) {
+    size_t n = 0;
+    while (n < batchSize && reader.next(batch[n])) n++;
+    if (n == 0) break;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+      replay(batch[i]);
+    }
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    seconds += elapsed.count();
+  }
+
+  for (unsigned lane = 0; lane < lanes(); lane++) {
+    laneStats[lane].seconds += seconds / lanes();
+  }
+}
+
+#endif
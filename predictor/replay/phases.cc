@@ -0,0 +1,322 @@
+/*****************************************************************
+ * File: phases.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: SimPoint-style phase analysis of branch traces:
+ * per-interval basic block vectors, k-means clustering and the
+ * weighted representative intervals picked out of it.
+ ****************************************************************/
+
+#include "phases.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <unordered_map>
+
+#include "base/misc.hh"
+
+namespace
+{
+
+/** Random projection coefficient in [-1, 1) of a block for a dimension */
+double
+projection(Addr pc, unsigned dimension)
+{
+  // splitmix64 of the block and dimension
+  uint64_t x = pc * ULL(0x9e3779b97f4a7c15) + dimension;
+  x = (x ^ (x >> 30)) * ULL(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * ULL(0x94d049bb133111eb);
+  x ^= x >> 31;
+  return (double)(x >> 11) / (double)(ULL(1) << 52) - 1.0;
+}
+
+double
+squaredDistance(const std::vector<double> &a, const std::vector<double> &b)
+{
+  double sum = 0;
+  for (size_t d = 0; d < a.size(); d++) {
+    sum += (a[d] - b[d]) * (a[d] - b[d]);
+  }
+  return sum;
+}
+
+/** Index of the center closest to v, and the squared distance to it */
+size_t
+closest(const std::vector<std::vector<double> > &centers,
+        const std::vector<double> &v, double &distance)
+{
+  size_t best = 0;
+  distance = std::numeric_limits<double>::max();
+  for (size_t c = 0; c < centers.size(); c++) {
+    const double d = squaredDistance(centers[c], v);
+    if (d < distance) {
+      distance = d;
+      best = c;
+    }
+  }
+  return best;
+}
+
+/**
+ * BIC of a clustering of R vectors of M dimensions into k spherical
+ * gaussians of a common variance (the X-means formulation).
+ */
+double
+bic(const Clustering &clustering, size_t points, size_t dimensions)
+{
+  const double R = points, M = dimensions;
+  const double k = clustering.centers.size();
+  if (R <= k) return -std::numeric_limits<double>::max();
+
+  std::vector<double> sizes(clustering.centers.size(), 0);
+  for (size_t i = 0; i < points; i++) sizes[clustering.cluster[i]]++;
+
+  // identical vectors would give a zero variance
+  const double variance =
+    std::max(clustering.distortion / (M * (R - k)), 1e-12);
+  double likelihood = -R * M / 2 * std::log(2 * M_PI * variance) -
+    M * (R - k) / 2;
+  for (size_t c = 0; c < sizes.size(); c++) {
+    if (sizes[c] > 0) likelihood += sizes[c] * std::log(sizes[c] / R);
+  }
+
+  const double parameters = (k - 1) + M * k + 1;
+  return likelihood - parameters / 2 * std::log(R);
+}
+
+} // anonymous namespace
+
+std::vector<TraceInterval>
+splitIntervals(const MappedTrace &trace, uint64_t instructions)
+{
+  std::vector<TraceInterval> intervals;
+  TraceInterval current = { 0, 0, 0 };
+  BinaryTraceReader reader(trace);
+  BranchRecord rec;
+  while (reader.next(rec)) {
+    current.last++;
+    current.instructions += rec.instGap;
+    if (current.instructions >= instructions) {
+      intervals.push_back(current);
+      current.first = current.last;
+      current.instructions = 0;
+    }
+  }
+  if (current.last > current.first) intervals.push_back(current);
+  return intervals;
+}
+
+std::vector<std::vector<double> >
+basicBlockVectors(const MappedTrace &trace,
+                  const std::vector<TraceInterval> &intervals,
+                  unsigned dimensions)
+{
+  std::vector<std::vector<double> > vectors;
+  std::unordered_map<Addr, uint64_t> blocks;
+  for (size_t i = 0; i < intervals.size(); i++) {
+    // count the blocks first, as there are far fewer of them than
+    // records, then project them
+    blocks.clear();
+    BinaryTraceReader reader(trace, intervals[i].first, intervals[i].last);
+    BranchRecord rec;
+    while (reader.next(rec)) blocks[rec.pc] += rec.instGap;
+
+    std::vector<double> v(dimensions, 0);
+    for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+      for (unsigned d = 0; d < dimensions; d++) {
+        v[d] += it->second * projection(it->first, d);
+      }
+    }
+    if (intervals[i].instructions > 0) {
+      for (unsigned d = 0; d < dimensions; d++) {
+        v[d] /= intervals[i].instructions;
+      }
+    }
+    vectors.push_back(v);
+  }
+  return vectors;
+}
+
+Clustering
+kmeans(const std::vector<std::vector<double> > &vectors, unsigned k,
+       uint64_t seed, unsigned iterations)
+{
+  if (k == 0 || k > vectors.size()) {
+    fatal("Cannot cluster %zu vectors into %u clusters\n",
+          vectors.size(), k);
+  }
+
+  // k-means++: every next center is drawn with a probability
+  // proportional to its squared distance to the closest center so far
+  std::mt19937_64 rng(seed);
+  Clustering clustering;
+  std::uniform_int_distribution<size_t> first(0, vectors.size() - 1);
+  clustering.centers.push_back(vectors[first(rng)]);
+  std::vector<double> distances(vectors.size());
+  while (clustering.centers.size() < k) {
+    double total = 0;
+    for (size_t i = 0; i < vectors.size(); i++) {
+      closest(clustering.centers, vectors[i], distances[i]);
+      total += distances[i];
+    }
+    size_t next = 0;
+    if (total > 0) {
+      double pick = std::uniform_real_distribution<double>(0, total)(rng);
+      while (next + 1 < vectors.size() && pick >= distances[next]) {
+        pick -= distances[next++];
+      }
+    } else {
+      next = clustering.centers.size();
+    }
+    clustering.centers.push_back(vectors[next]);
+  }
+
+  const size_t dimensions = vectors[0].size();
+  clustering.cluster.assign(vectors.size(), k);
+  for (unsigned iteration = 0; iteration < iterations; iteration++) {
+    bool moved = false;
+    for (size_t i = 0; i < vectors.size(); i++) {
+      double distance;
+      const unsigned c = closest(clustering.centers, vectors[i], distance);
+      if (c != clustering.cluster[i]) {
+        clustering.cluster[i] = c;
+        moved = true;
+      }
+    }
+    if (!moved) break;
+
+    // an emptied cluster keeps its center
+    std::vector<std::vector<double> > sums(k,
+                                           std::vector<double>(dimensions, 0));
+    std::vector<size_t> sizes(k, 0);
+    for (size_t i = 0; i < vectors.size(); i++) {
+      const unsigned c = clustering.cluster[i];
+      sizes[c]++;
+      for (size_t d = 0; d < dimensions; d++) sums[c][d] += vectors[i][d];
+    }
+    for (unsigned c = 0; c < k; c++) {
+      if (sizes[c] == 0) continue;
+      for (size_t d = 0; d < dimensions; d++) {
+        clustering.centers[c][d] = sums[c][d] / sizes[c];
+      }
+    }
+  }
+
+  clustering.distortion = 0;
+  for (size_t i = 0; i < vectors.size(); i++) {
+    clustering.distortion +=
+      squaredDistance(vectors[i], clustering.centers[clustering.cluster[i]]);
+  }
+  clustering.bic = bic(clustering, vectors.size(), dimensions);
+  return clustering;
+}
+
+std::vector<SimPoint>
+pickSimPoints(const std::vector<std::vector<double> > &vectors,
+              const std::vector<TraceInterval> &intervals,
+              const PhaseOptions &options, Clustering &clustering)
+{
+  if (vectors.empty()) fatal("No intervals to cluster\n");
+
+  // best of the restarts for every k
+  std::vector<Clustering> candidates;
+  const unsigned max_k = std::min<size_t>(options.maxK, vectors.size());
+  for (unsigned k = 1; k <= max_k; k++) {
+    Clustering best;
+    for (unsigned seed = 0; seed < std::max(options.seeds, 1u); seed++) {
+      Clustering attempt = kmeans(vectors, k, seed);
+      if (seed == 0 || attempt.distortion < best.distortion) best = attempt;
+    }
+    candidates.push_back(best);
+  }
+
+  double low = candidates[0].bic, high = candidates[0].bic;
+  for (size_t i = 1; i < candidates.size(); i++) {
+    low  = std::min(low, candidates[i].bic);
+    high = std::max(high, candidates[i].bic);
+  }
+  size_t picked = 0;
+  while (picked + 1 < candidates.size() &&
+         candidates[picked].bic < low + options.bicThreshold * (high - low)) {
+    picked++;
+  }
+  clustering = candidates[picked];
+
+  uint64_t total = 0;
+  for (size_t i = 0; i < intervals.size(); i++) {
+    total += intervals[i].instructions;
+  }
+
+  std::vector<SimPoint> points;
+  for (unsigned c = 0; c < clustering.centers.size(); c++) {
+    SimPoint point;
+    double nearest = std::numeric_limits<double>::max();
+    uint64_t instructions = 0;
+    for (size_t i = 0; i < vectors.size(); i++) {
+      if (clustering.cluster[i] != c) continue;
+      instructions += intervals[i].instructions;
+      const double d = squaredDistance(vectors[i], clustering.centers[c]);
+      if (d < nearest) {
+        nearest = d;
+        point.interval = i;
+      }
+    }
+    if (instructions == 0) continue;
+    point.range  = intervals[point.interval];
+    point.weight = total ? (double)instructions / total : 0;
+    points.push_back(point);
+  }
+  return points;
+}
+
+void
+writeSimPoints(const std::string &filename,
+               const std::vector<SimPoint> &points)
+{
+  FILE *file = std::fopen(filename.c_str(), "w");
+  if (!file) fatal("Could not create %s\n", filename.c_str());
+
+  std::fprintf(file, "# interval first last instructions weight\n");
+  for (size_t i = 0; i < points.size(); i++) {
+    std::fprintf(file, "%llu %llu %llu %llu %.9f\n",
+                 (unsigned long long)points[i].interval,
+                 (unsigned long long)points[i].range.first,
+                 (unsigned long long)points[i].range.last,
+                 (unsigned long long)points[i].range.instructions,
+                 points[i].weight);
+  }
+  if (std::fclose(file) != 0) fatal("Could not write %s\n", filename.c_str());
+}
+
+std::vector<SimPoint>
+readSimPoints(const std::string &filename)
+{
+  FILE *file = std::fopen(filename.c_str(), "r");
+  if (!file) fatal("Could not open %s\n", filename.c_str());
+
+  std::vector<SimPoint> points;
+  char line[256];
+  unsigned number = 0;
+  while (std::fgets(line, sizeof(line), file)) {
+    number++;
+    if (line[0] == '#' || line[0] == '\n') continue;
+
+    unsigned long long interval, first, last, instructions;
+    SimPoint point;
+    if (std::sscanf(line, "%llu %llu %llu %llu %lf", &interval, &first,
+                    &last, &instructions, &point.weight) != 5 ||
+        first > last) {
+      fatal("%s:%u: malformed simulation point\n", filename.c_str(), number);
+    }
+    point.interval           = interval;
+    point.range.first        = first;
+    point.range.last         = last;
+    point.range.instructions = instructions;
+    points.push_back(point);
+  }
+  std::fclose(file);
+  return points;
+}
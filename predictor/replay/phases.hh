@@ -0,0 +1,134 @@
+/*****************************************************************
+ * File: phases.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: SimPoint-style phase analysis of branch traces:
+ * per-interval basic block vectors, k-means clustering and the
+ * weighted representative intervals picked out of it: header file.
+ ****************************************************************/
+
+#ifndef __REPLAY_PHASES_HH__
+#define __REPLAY_PHASES_HH__
+
+#include <string>
+#include <vector>
+
+#include "trace.hh"
+
+/** A range of records of a trace, and the instructions they cover */
+struct TraceInterval
+{
+  uint64_t first;
+  uint64_t last;
+  uint64_t instructions;
+};
+
+/**
+ * Splits a binary trace into consecutive intervals of (at least) the
+ * given number of instructions, the last one being whatever is left.
+ */
+std::vector<TraceInterval> splitIntervals(const MappedTrace &trace,
+                                          uint64_t instructions);
+
+/**
+ * Basic block vectors of the given intervals, randomly projected down
+ * to the given number of dimensions. A basic block is identified by
+ * the branch ending it and counted for the instructions since the
+ * previous branch; each vector is normalized by the instructions of its
+ * interval, so that intervals running the same code in the same
+ * proportions get the same vector whatever their length.
+ */
+std::vector<std::vector<double> >
+basicBlockVectors(const MappedTrace &trace,
+                  const std::vector<TraceInterval> &intervals,
+                  unsigned dimensions);
+
+/** Clustering of the interval vectors */
+struct Clustering
+{
+  /** Cluster of each vector */
+  std::vector<unsigned> cluster;
+
+  /** Center of each cluster */
+  std::vector<std::vector<double> > centers;
+
+  /** Sum of the squared distances of the vectors to their centers */
+  double distortion;
+
+  /**
+   * Bayesian information criterion of the clustering, modelling the
+   * clusters as spherical gaussians of a common variance; the higher
+   * the better.
+   */
+  double bic;
+};
+
+/**
+ * Clusters vectors with k-means, started from a k-means++ seeding.
+ * @param vectors Vectors to be clustered, at least k of them.
+ * @param k Number of clusters.
+ * @param seed Seed of the random initial centers.
+ * @param iterations Maximum number of iterations.
+ */
+Clustering kmeans(const std::vector<std::vector<double> > &vectors,
+                  unsigned k, uint64_t seed, unsigned iterations = 100);
+
+/** A representative interval of a trace and its weight */
+struct SimPoint
+{
+  /** Index of the interval */
+  uint64_t interval;
+
+  /** Records of the interval */
+  TraceInterval range;
+
+  /** Fraction of the instructions of the trace it stands for */
+  double weight;
+};
+
+/** Options of pickSimPoints */
+struct PhaseOptions
+{
+  PhaseOptions()
+    : maxK(10), seeds(5), bicThreshold(0.9)
+  { }
+
+  /** Largest number of clusters tried */
+  unsigned maxK;
+
+  /** Number of random restarts of k-means per number of clusters */
+  unsigned seeds;
+
+  /**
+   * The smallest number of clusters whose BIC reaches this fraction of
+   * the range of the BICs of all the numbers tried is picked.
+   */
+  double bicThreshold;
+};
+
+/**
+ * Clusters the intervals of a trace and picks, for every cluster, the
+ * interval closest to its center, weighted by the share of the
+ * instructions of the trace falling in the cluster.
+ * @param vectors Basic block vectors of the intervals.
+ * @param intervals The intervals.
+ * @param options Clustering options.
+ * @param clustering Filled in with the clustering picked.
+ */
+std::vector<SimPoint>
+pickSimPoints(const std::vector<std::vector<double> > &vectors,
+              const std::vector<TraceInterval> &intervals,
+              const PhaseOptions &options, Clustering &clustering);
+
+/**
+ * Writes simulation points as text, one line per point: interval
+ * index, first and last record and instructions of the interval, and
+ * weight.
+ */
+void writeSimPoints(const std::string &filename,
+                    const std::vector<SimPoint> &points);
+
+/** Reads simulation points written by writeSimPoints, exiting on error */
+std::vector<SimPoint> readSimPoints(const std::string &filename);
+
+#endif
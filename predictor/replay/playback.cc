@@ -0,0 +1,252 @@
+/*****************************************************************
+ * File: playback.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Playback of the predictor calls captured by CaptureBP
+ * during a gem5 run through any predictor.
+ ****************************************************************/
+
+#include "playback.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "base/misc.hh"
+#include "cpu/pred/capture.hh"
+
+namespace
+{
+
+/** What became of a captured branch, as bits */
+enum BranchFate
+{
+  FateCommitted = 1, // committed by an update
+  FateTaken     = 2, // taken, if committed
+  FateCorrected = 4  // corrected by a squashing update before its commit
+};
+
+/** Streams the calls of a capture in blocks */
+class CaptureReader
+{
+public:
+  CaptureReader(const std::string &filename)
+    : file(std::fopen(filename.c_str(), "rb")), filename(filename),
+      left(0), block(4096), cur(0), end(0)
+  {
+    if (!file) fatal("Could not open capture %s\n", filename.c_str());
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, captureMagic, sizeof(header.magic))) {
+      fatal("%s is not a predictor capture\n", filename.c_str());
+    }
+    if (header.version != captureVersion ||
+        header.recordSize != sizeof(PackedCall)) {
+      fatal("%s: unsupported capture version %u\n", filename.c_str(),
+            header.version);
+    }
+    left = header.calls;
+  }
+
+  ~CaptureReader() { std::fclose(file); }
+
+  bool next(PackedCall &call)
+  {
+    if (cur == end) {
+      if (left == 0) return false;
+      end = left < block.size() ? left : block.size();
+      if (std::fread(block.data(), sizeof(PackedCall), end, file) != end) {
+        fatal("%s: capture is truncated\n", filename.c_str());
+      }
+      left -= end;
+      cur = 0;
+    }
+    call = block[cur++];
+    return true;
+  }
+
+  const CaptureHeader &info() const { return header; }
+
+private:
+  FILE *file;
+  std::string filename;
+  CaptureHeader header;
+
+  /** Calls not read from the file yet */
+  uint64_t left;
+
+  /** Block of calls read, and the part of it not consumed yet */
+  std::vector<PackedCall> block;
+  size_t cur;
+  size_t end;
+};
+
+/** A branch in flight during the playback */
+struct PlayedBranch
+{
+  void *history;
+  Addr pc;
+  ThreadID tid;
+  bool cond;
+  bool predicted;
+  bool done;
+};
+
+} // anonymous namespace
+
+bool
+isCapture(const std::string &filename)
+{
+  char magic[sizeof(captureMagic)];
+  FILE *file = std::fopen(filename.c_str(), "rb");
+  if (!file) return false;
+  bool capture = std::fread(magic, sizeof(magic), 1, file) == 1 &&
+                 std::memcmp(magic, captureMagic, sizeof(magic)) == 0;
+  std::fclose(file);
+  return capture;
+}
+
+void
+playCapture(BPredUnit *bp, const std::string &filename,
+            PlaybackStats &stats)
+{
+  // what became of every branch decides which corrections are played
+  std::vector<unsigned char> fates;
+  {
+    CaptureReader reader(filename);
+    fates.assign(reader.info().histories, 0);
+    PackedCall call;
+    while (reader.next(call)) {
+      if (call.history >= fates.size()) {
+        fatal("%s: call of unknown branch %llu\n", filename.c_str(),
+              (unsigned long long)call.history);
+      }
+      unsigned char &fate = fates[call.history];
+      if (callKind(call) == CallUpdate) {
+        fate |= FateCommitted | (callFlag(call) ? FateTaken : 0);
+      } else if (callKind(call) == CallSquashedUpdate) {
+        fate |= FateCorrected;
+      }
+    }
+  }
+
+  CaptureReader reader(filename);
+  stats.replay.instructions += reader.info().instructions;
+
+  // branches from number base on, released in about program order
+  std::deque<PlayedBranch> in_flight;
+  uint64_t base = 0;
+  bool pending = false;
+  uint64_t pending_branch = 0;
+  const uint64_t trained = bp->trainedBranches();
+
+  auto start = std::chrono::steady_clock::now();
+  PackedCall call;
+  for (;;) {
+    const bool more = reader.next(call);
+    const CapturedCallKind kind = more ? callKind(call) : CallSquash;
+
+    // the branch last looked up is resolved once the calls of its
+    // prediction are done: correct it if it was mispredicted when
+    // the captured predictor got it right
+    if (pending && !(more && kind == CallBTBUpdate &&
+                     call.history == pending_branch)) {
+      PlayedBranch &branch = in_flight[pending_branch - base];
+      const unsigned char fate = fates[pending_branch];
+      const bool taken = fate & FateTaken;
+      if ((fate & FateCommitted) && !(fate & FateCorrected) &&
+          branch.predicted != taken) {
+        bp->update(branch.tid, branch.pc, taken, branch.history, true);
+        stats.added++;
+      }
+      pending = false;
+    }
+    if (!more) break;
+    stats.calls++;
+
+    if (kind == CallLookup || kind == CallUncondBranch) {
+      if (call.history != base + in_flight.size()) {
+        fatal("%s: branch %llu created out of order\n", filename.c_str(),
+              (unsigned long long)call.history);
+      }
+      PlayedBranch branch;
+      branch.history   = NULL;
+      branch.pc        = callPC(call);
+      branch.tid       = callThread(call);
+      branch.cond      = kind == CallLookup;
+      branch.done      = false;
+      if (branch.cond) {
+        branch.predicted = bp->lookup(branch.tid, branch.pc, branch.history);
+        if (branch.predicted != callFlag(call)) stats.divergent++;
+        pending        = true;
+        pending_branch = call.history;
+      } else {
+        bp->uncondBranch(branch.tid, branch.pc, branch.history);
+        branch.predicted = true;
+      }
+      in_flight.push_back(branch);
+      continue;
+    }
+
+    if (call.history < base || call.history >= base + in_flight.size() ||
+        in_flight[call.history - base].done) {
+      fatal("%s: call of branch %llu out of its lifetime\n",
+            filename.c_str(), (unsigned long long)call.history);
+    }
+    PlayedBranch &branch = in_flight[call.history - base];
+    const unsigned char fate = fates[call.history];
+
+    switch (kind) {
+      case CallBTBUpdate:
+        // only a branch predicted taken looks its target up
+        if (branch.cond && !branch.predicted) {
+          stats.dropped++;
+          break;
+        }
+        bp->btbUpdate(branch.tid, branch.pc, branch.history);
+        branch.predicted = false;
+        break;
+
+      case CallSquashedUpdate:
+        if (branch.cond && (fate & FateCommitted) &&
+            branch.predicted == (bool)(fate & FateTaken)) {
+          stats.dropped++;
+          break;
+        }
+        bp->update(branch.tid, branch.pc, callFlag(call), branch.history,
+                   true);
+        break;
+
+      case CallUpdate:
+        bp->update(branch.tid, branch.pc, callFlag(call), branch.history,
+                   false);
+        stats.replay.branches++;
+        if (branch.cond) {
+          stats.replay.condBranches++;
+          if (branch.predicted != callFlag(call)) {
+            stats.replay.condIncorrect++;
+          }
+        }
+        branch.done = true;
+        break;
+
+      case CallSquash:
+        bp->squash(branch.tid, branch.history);
+        branch.done = true;
+        break;
+
+      default:
+        fatal("%s: unknown call %u\n", filename.c_str(), (unsigned)kind);
+    }
+
+    while (!in_flight.empty() && in_flight.front().done) {
+      in_flight.pop_front();
+      base++;
+    }
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  stats.replay.seconds += elapsed.count();
+  stats.replay.trained += bp->trainedBranches() - trained;
+}
@@ -0,0 +1,69 @@
+/*****************************************************************
+ * File: playback.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Playback of the predictor calls captured by CaptureBP
+ * during a gem5 run through any predictor: header file.
+ ****************************************************************/
+
+#ifndef __REPLAY_PLAYBACK_HH__
+#define __REPLAY_PLAYBACK_HH__
+
+#include <string>
+
+#include "cpu/pred/bpred_unit.hh"
+#include "engine.hh"
+
+/** Counts accumulated over the playback of a capture */
+struct PlaybackStats
+{
+  PlaybackStats() : calls(0), divergent(0), added(0), dropped(0) { }
+
+  /**
+   * Committed branches and their mispredictions by the played back
+   * predictor; instructions are those of the capture, if known.
+   */
+  ReplayStats replay;
+
+  /** Calls read from the capture */
+  uint64_t calls;
+
+  /** Lookups predicted otherwise than by the captured predictor */
+  uint64_t divergent;
+
+  /** Squashing updates added, and captured calls left out, for them */
+  uint64_t added;
+  uint64_t dropped;
+};
+
+/** Whether the given file starts with the capture magic string */
+bool isCapture(const std::string &filename);
+
+/**
+ * Plays the calls of a capture (see CaptureBP) back through a
+ * predictor, in their order and with their arguments, every history
+ * the capture numbers being that the predictor returned for the branch.
+ *
+ * Played back through the predictor it was captured from, the calls
+ * are exactly those of the gem5 run and so are the predictions. Another
+ * predictor mispredicts other branches, which the CPU would have
+ * corrected instead: the squashing update of a committed conditional
+ * branch is only passed on if the predictor mispredicted it, and one is
+ * added right after the lookup (and btbUpdate) if it mispredicted a
+ * branch the captured one did not. A btbUpdate (a BTB miss on a branch
+ * predicted taken) is only passed on if the branch is predicted taken,
+ * and then makes it predicted not taken, as in BPredUnit::predict, the
+ * BTB misses being those of the captured run. BTB aside, this is exact
+ * for the in-order CPUs, which only fetch past a branch once it is
+ * resolved. With the O3 CPU, the wrong-path branches and their squashes
+ * stay those of the captured run, which is the approximation of any
+ * trace-driven replay.
+ *
+ * @param bp Predictor the calls are played back through.
+ * @param filename Path to the capture, exiting if it is not one.
+ * @param stats Counts to be updated.
+ */
+void playCapture(BPredUnit *bp, const std::string &filename,
+                 PlaybackStats &stats);
+
+#endif
@@ -0,0 +1,602 @@
+/*****************************************************************
+ * File: replay.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Command line driver replaying recorded branch traces
+ * through the neural predictors without running gem5. Reports the
+ * conditional MPKI and the predictor latency per branch.
+ ****************************************************************/
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/misc.hh"
+#include "cpu/pred/capture.hh"
+#include "engine.hh"
+#include "phases.hh"
+#include "playback.hh"
+#include "trace.hh"
+#include "work_stealing_pool.hh"
+
+namespace
+{
+
+void
+usage(const char *prog)
+{
+  std::fprintf(stderr,
+    "usage: %s [options] trace...\n"
+    "  traces are either text dumps, binary traces written by convert or\n"
+    "  predictor calls captured from gem5 by CaptureBP, played back\n"
+    "  --pred NAME       predictor to replay: NeuroBP, NeuroPathBP,\n"
+    "                    PiecewiseLinearBP, HashedPerceptronBP, AlwaysBP\n"
+    "                    (default NeuroBP)\n"
+    "  --size N          globalPredictorSize of the neural predictors,\n"
+    "                    i.e. their history length (default 8192)\n"
+    "  --weight-bits N   width of the saturating perceptron weights,\n"
+    "                    2-16 (default 8)\n"
+    "  --perceptrons N   perceptronCount of the neural predictors\n"
+    "                    (default 20 for NeuroBP, 10 for NeuroPathBP,\n"
+    "                    64 for PiecewiseLinearBP)\n"
+    "  --pc-count N      pcCount of PiecewiseLinearBP (default 8)\n"
+    "  --tables N        numTables of HashedPerceptronBP (default 8)\n"
+    "  --table-size N    tableSize of HashedPerceptronBP (default 1024)\n"
+    "  --theta MODE      training threshold of the neural predictors:\n"
+    "                    fixed (default), adaptive or perceptron\n"
+    "                    (adaptive, one threshold per perceptron)\n"
+    "  --smt             replay the (binary) traces together, each on its\n"
+    "                    own hardware thread of a single predictor,\n"
+    "                    interleaving them branch by branch\n"
+    "  --chunks K        replay each (binary) trace as K chunks in\n"
+    "                    parallel, each on its own predictor\n"
+    "  --warmup N        records before each chunk or simulation point\n"
+    "                    it is warmed up on (default 1000000)\n"
+    "  --sample P        replay only a sample of each (binary) trace: out\n"
+    "                    of every P records, a window measured after a\n"
+    "                    functional warmup\n"
+    "  --sample-window N records measured per period (default 10000)\n"
+    "  --sample-warmup N records the predictor is trained on, uncounted,\n"
+    "                    before each window (default 90000)\n"
+    "  --confidence C    confidence level of the sampled MPKI interval\n"
+    "                    (default 0.997)\n"
+    "  --simpoints FILE  replay only the representative intervals of the\n"
+    "                    (binary) trace picked by simpoint, each warmed\n"
+    "                    up on the --warmup records before it, and\n"
+    "                    report their weighted accuracy and MPKI\n"
+    "  --result-cache DIR\n"
+    "                    look whole replays up in a result cache, keyed\n"
+    "                    by the predictor sources, the configuration and\n"
+    "                    the trace contents, and store the new ones\n"
+    "  --sources DIR     predictor directory the cache keys hash the\n"
+    "                    sources of (default: above the replay binary)\n"
+    "  --capture FILE    also capture the predictor calls of the (whole)\n"
+    "                    replay of a single trace into FILE, as CaptureBP\n"
+    "                    does in gem5\n"
+    "  --check           also replay each chunked, sampled or simpoint\n"
+    "                    trace sequentially and report the error of the\n"
+    "                    chunked counts or estimated MPKI\n", prog);
+  std::exit(1);
+}
+
+void
+report(const std::string &trace, const ReplayConfig &config,
+       const ReplayStats &stats)
+{
+  std::printf("trace : %s\n", trace.c_str());
+  std::printf("predictor : %s\n", config.predictor.c_str());
+  std::printf("globalPredictorSize : %u\n", config.globalPredictorSize);
+  std::printf("weightBits : %u\n", config.weightBits);
+  std::printf("instructions : %llu\n",
+              (unsigned long long)stats.instructions);
+  std::printf("branches : %llu\n", (unsigned long long)stats.branches);
+  std::printf("condBranches : %llu\n",
+              (unsigned long long)stats.condBranches);
+  std::printf("condIncorrect : %llu\n",
+              (unsigned long long)stats.condIncorrect);
+  std::printf("accuracy : %.4f\n", stats.accuracy());
+  std::printf("mpki : %.4f\n", stats.mpki());
+  std::printf("trained : %llu\n", (unsigned long long)stats.trained);
+  if (stats.cached) std::printf("ns_per_branch : -\n");
+  else              std::printf("ns_per_branch : %.2f\n", stats.nsPerBranch());
+}
+
+/**
+ * Plays a capture back through the predictor and reports the counts,
+ * along with how far the predictor strayed from the captured one.
+ */
+void
+playBack(const ReplayConfig &config, const std::string &filename)
+{
+  std::unique_ptr<BPredUnit> bp(createPredictor(config));
+  PlaybackStats stats;
+  playCapture(bp.get(), filename, stats);
+  report(filename, config, stats.replay);
+  std::printf("calls : %llu\n", (unsigned long long)stats.calls);
+  std::printf("divergent_predictions : %llu\n",
+              (unsigned long long)stats.divergent);
+  std::printf("added_corrections : %llu\n",
+              (unsigned long long)stats.added);
+  std::printf("dropped_calls : %llu\n", (unsigned long long)stats.dropped);
+}
+
+/**
+ * Replays a whole trace through the predictor wrapped in CaptureBP,
+ * writing its calls out to the given capture, and reports the counts.
+ */
+void
+replayCapturing(const ReplayConfig &config, const std::string &filename,
+                const std::string &capture)
+{
+  std::unique_ptr<BPredUnit> bp(createPredictor(config));
+  CaptureBPParams params;
+  params.numThreads  = config.numThreads;
+  params.predictor   = bp.get();
+  params.captureFile = capture;
+  CaptureBP capture_bp(&params);
+
+  ReplayEngine engine(&capture_bp);
+  ReplayStats stats;
+  if (isBinaryTrace(filename)) {
+    MappedTrace trace(filename);
+    BinaryTraceReader reader(trace);
+    engine.replayAll(reader, stats);
+  } else {
+    TextTraceReader reader(filename);
+    engine.replayAll(reader, stats);
+  }
+  capture_bp.addInstructions(stats.instructions);
+  capture_bp.close();
+  // the engine only saw CaptureBP, which does not count training
+  stats.trained = bp->trainedBranches();
+  report(filename, config, stats);
+}
+
+/**
+ * Replays every trace on its own hardware thread of one predictor,
+ * one branch of each thread in turn, until all of them are done.
+ */
+void
+replaySMT(ReplayConfig config, char **traces, int count)
+{
+  config.numThreads = count;
+  std::unique_ptr<BPredUnit> bp(createPredictor(config));
+
+  std::vector<std::unique_ptr<MappedTrace>> mapped;
+  std::vector<std::unique_ptr<BinaryTraceReader>> readers;
+  std::vector<ReplayEngine> engines;
+  std::vector<ReplayStats> stats(count);
+  for (int t = 0; t < count; t++) {
+    if (!isBinaryTrace(traces[t])) {
+      fatal("--smt needs binary traces, convert %s first\n", traces[t]);
+    }
+    mapped.emplace_back(new MappedTrace(traces[t]));
+    readers.emplace_back(new BinaryTraceReader(*mapped.back()));
+    engines.push_back(ReplayEngine(bp.get(), t));
+  }
+
+  // the records of a batch of turns are decoded before they are
+  // replayed, so that only the predictor is timed
+  const size_t turns = 4096;
+  std::vector<std::vector<BranchRecord>> batches(
+    count, std::vector<BranchRecord>(turns));
+  std::vector<size_t> decoded(count);
+  double seconds = 0;
+  for (;;) {
+    size_t most = 0;
+    for (int t = 0; t < count; t++) {
+      size_t &n = decoded[t];
+      for (n = 0; n < turns && readers[t]->next(batches[t][n]); n++) { }
+      most = std::max(most, n);
+    }
+    if (most == 0) break;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < most; i++) {
+      for (int t = 0; t < count; t++) {
+        if (i < decoded[t]) engines[t].replay(batches[t][i], stats[t]);
+      }
+    }
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    seconds += elapsed.count();
+  }
+
+  // the threads share the predictor, so the time is split between them
+  // by the branches each replayed
+  uint64_t branches = 0;
+  for (int t = 0; t < count; t++) branches += stats[t].branches;
+  for (int t = 0; t < count; t++) {
+    if (branches > 0) {
+      stats[t].seconds = seconds * stats[t].branches / branches;
+    }
+  }
+
+  for (int t = 0; t < count; t++) {
+    if (t > 0) std::printf("\n");
+    std::printf("thread : %d\n", t);
+    report(traces[t], config, stats[t]);
+  }
+}
+
+/**
+ * Replays a whole binary trace on a single predictor.
+ * @return The wall-clock time of the replay, in seconds.
+ */
+double
+replaySequential(const ReplayConfig &config, const MappedTrace &trace,
+                 ReplayStats &stats)
+{
+  std::unique_ptr<BPredUnit> bp(createPredictor(config));
+  ReplayEngine engine(bp.get());
+  auto start = std::chrono::steady_clock::now();
+  BinaryTraceReader reader(trace);
+  engine.replayAll(reader, stats);
+  std::chrono::duration<double> wall =
+    std::chrono::steady_clock::now() - start;
+  return wall.count();
+}
+
+/**
+ * Replays a binary trace in chunks on a pool of threads (see
+ * replayChunk) and reports the merged counts along with the wall-clock
+ * time, and, if check is set, the counts and time of a sequential
+ * replay of the trace and the error of the chunked ones.
+ */
+void
+replayChunked(const ReplayConfig &config, const std::string &filename,
+              unsigned chunks, uint64_t warmup, bool check)
+{
+  if (!isBinaryTrace(filename)) {
+    fatal("--chunks needs binary traces, convert %s first\n",
+          filename.c_str());
+  }
+  MappedTrace trace(filename);
+  std::vector<ReplayChunk> split = splitTrace(trace.records(), chunks,
+                                              warmup);
+  std::vector<ReplayStats> chunk_stats(split.size());
+
+  const unsigned threads =
+    std::min<unsigned>(split.size(), std::thread::hardware_concurrency());
+  auto start = std::chrono::steady_clock::now();
+  {
+    WorkStealingPool pool(threads);
+    for (size_t k = 0; k < split.size(); k++) {
+      pool.submit([&, k] {
+        replayChunk(config, trace, split[k], chunk_stats[k]);
+      });
+    }
+    pool.wait();
+  }
+  std::chrono::duration<double> chunked_wall =
+    std::chrono::steady_clock::now() - start;
+
+  ReplayStats stats;
+  for (size_t k = 0; k < split.size(); k++) stats.merge(chunk_stats[k]);
+  report(filename, config, stats);
+  std::printf("chunks : %zu\n", split.size());
+  std::printf("warmup : %llu\n", (unsigned long long)warmup);
+  std::printf("wall_seconds : %.2f\n", chunked_wall.count());
+  if (!check) return;
+
+  ReplayStats sequential;
+  const double sequential_wall = replaySequential(config, trace, sequential);
+
+  const long long error =
+    (long long)stats.condIncorrect - (long long)sequential.condIncorrect;
+  std::printf("sequential_condIncorrect : %llu\n",
+              (unsigned long long)sequential.condIncorrect);
+  std::printf("sequential_mpki : %.4f\n", sequential.mpki());
+  std::printf("condIncorrect_error : %lld\n", error);
+  std::printf("mpki_error : %.4f\n", stats.mpki() - sequential.mpki());
+  std::printf("relative_error : %.4f\n", sequential.condIncorrect
+              ? (double)error / sequential.condIncorrect : 0.0);
+  std::printf("sequential_wall_seconds : %.2f\n", sequential_wall);
+  std::printf("speedup : %.2f\n", sequential_wall / chunked_wall.count());
+}
+
+/**
+ * Replays periodic samples of a binary trace (see replaySampled) and
+ * reports the counts of the windows along with the estimated MPKI of
+ * the trace, its confidence interval and the number of windows needed
+ * for an interval of +-3%, and, if check is set, the MPKI and time of
+ * a sequential replay of the trace.
+ */
+void
+replaySampledTrace(const ReplayConfig &config, const std::string &filename,
+                   const ReplaySampling &sampling, double confidence,
+                   bool check)
+{
+  if (!isBinaryTrace(filename)) {
+    fatal("--sample needs binary traces, convert %s first\n",
+          filename.c_str());
+  }
+  MappedTrace trace(filename);
+  std::vector<ReplayStats> windows;
+  auto start = std::chrono::steady_clock::now();
+  replaySampled(config, trace, sampling, windows);
+  std::chrono::duration<double> sampled_wall =
+    std::chrono::steady_clock::now() - start;
+  if (windows.size() < 2) {
+    fatal("%s is too short to be sampled every %llu records\n",
+          filename.c_str(), (unsigned long long)sampling.period);
+  }
+
+  ReplayStats stats;
+  for (size_t i = 0; i < windows.size(); i++) stats.merge(windows[i]);
+  const MpkiEstimate estimate = estimateMpki(windows, confidence);
+  report(filename, config, stats);
+  std::printf("windows : %zu\n", estimate.windows);
+  std::printf("sample_period : %llu\n",
+              (unsigned long long)sampling.period);
+  std::printf("sample_window : %llu\n",
+              (unsigned long long)sampling.window);
+  std::printf("sample_warmup : %llu\n",
+              (unsigned long long)sampling.warmup);
+  std::printf("confidence : %.4f\n", confidence);
+  std::printf("mpki_interval : %.4f\n", estimate.halfWidth);
+  std::printf("mpki_low : %.4f\n", estimate.mpki - estimate.halfWidth);
+  std::printf("mpki_high : %.4f\n", estimate.mpki + estimate.halfWidth);
+  std::printf("windows_for_3pct : %llu\n",
+              (unsigned long long)windowsNeeded(estimate, confidence, 0.03));
+  std::printf("wall_seconds : %.2f\n", sampled_wall.count());
+  if (!check) return;
+
+  ReplayStats sequential;
+  const double sequential_wall = replaySequential(config, trace, sequential);
+  std::printf("sequential_mpki : %.4f\n", sequential.mpki());
+  std::printf("mpki_error : %.4f\n", stats.mpki() - sequential.mpki());
+  std::printf("sequential_wall_seconds : %.2f\n", sequential_wall);
+  std::printf("speedup : %.2f\n", sequential_wall / sampled_wall.count());
+}
+
+/**
+ * Replays the representative intervals of a binary trace in parallel,
+ * each on its own predictor warmed up on the records before it (see
+ * replayChunk), and reports their counts along with the accuracy and
+ * MPKI of the trace estimated from their weights, and, if check is set,
+ * the MPKI and time of a sequential replay of the trace.
+ */
+void
+replaySimPoints(const ReplayConfig &config, const std::string &filename,
+                const std::string &simpoints, uint64_t warmup, bool check)
+{
+  if (!isBinaryTrace(filename)) {
+    fatal("--simpoints needs a binary trace, convert %s first\n",
+          filename.c_str());
+  }
+  MappedTrace trace(filename);
+  std::vector<SimPoint> points = readSimPoints(simpoints);
+  if (points.empty()) fatal("%s has no simulation points\n",
+                            simpoints.c_str());
+
+  std::vector<ReplayChunk> chunks(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    if (points[i].range.last > trace.records()) {
+      fatal("%s does not match %s\n", simpoints.c_str(), filename.c_str());
+    }
+    chunks[i].first       = points[i].range.first;
+    chunks[i].last        = points[i].range.last;
+    chunks[i].warmupFirst = chunks[i].first > warmup
+                            ? chunks[i].first - warmup : 0;
+  }
+  std::vector<ReplayStats> point_stats(points.size());
+
+  const unsigned threads =
+    std::min<unsigned>(points.size(), std::thread::hardware_concurrency());
+  auto start = std::chrono::steady_clock::now();
+  {
+    WorkStealingPool pool(threads);
+    for (size_t i = 0; i < points.size(); i++) {
+      pool.submit([&, i] {
+        replayChunk(config, trace, chunks[i], point_stats[i]);
+      });
+    }
+    pool.wait();
+  }
+  std::chrono::duration<double> simpoint_wall =
+    std::chrono::steady_clock::now() - start;
+
+  // every interval stands for its weight of the instructions of the
+  // trace, at its own rates
+  ReplayStats stats;
+  double incorrect_rate = 0, cond_rate = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    stats.merge(point_stats[i]);
+    if (point_stats[i].instructions == 0) continue;
+    incorrect_rate += points[i].weight * point_stats[i].condIncorrect /
+      point_stats[i].instructions;
+    cond_rate += points[i].weight * point_stats[i].condBranches /
+      point_stats[i].instructions;
+  }
+  const double weighted_mpki = 1000 * incorrect_rate;
+  report(filename, config, stats);
+  std::printf("simpoints : %zu\n", points.size());
+  std::printf("warmup : %llu\n", (unsigned long long)warmup);
+  std::printf("weighted_accuracy : %.4f\n",
+              cond_rate > 0 ? 1 - incorrect_rate / cond_rate : 0.0);
+  std::printf("weighted_mpki : %.4f\n", weighted_mpki);
+  std::printf("wall_seconds : %.2f\n", simpoint_wall.count());
+  if (!check) return;
+
+  ReplayStats sequential;
+  const double sequential_wall = replaySequential(config, trace, sequential);
+  std::printf("sequential_accuracy : %.4f\n", sequential.accuracy());
+  std::printf("sequential_mpki : %.4f\n", sequential.mpki());
+  std::printf("mpki_error : %.4f\n", weighted_mpki - sequential.mpki());
+  std::printf("sequential_wall_seconds : %.2f\n", sequential_wall);
+  std::printf("speedup : %.2f\n", sequential_wall / simpoint_wall.count());
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    { "pred", required_argument, NULL, 'p' },
+    { "size", required_argument, NULL, 's' },
+    { "smt",  no_argument,       NULL, 't' },
+    { "weight-bits", required_argument, NULL, 'w' },
+    { "perceptrons", required_argument, NULL, 'c' },
+    { "tables",      required_argument, NULL, 'n' },
+    { "table-size",  required_argument, NULL, 'z' },
+    { "theta",       required_argument, NULL, 'a' },
+    { "chunks",      required_argument, NULL, 'K' },
+    { "warmup",      required_argument, NULL, 'W' },
+    { "check",       no_argument,       NULL, 'C' },
+    { "sample",        required_argument, NULL, 'S' },
+    { "sample-window", required_argument, NULL, 'U' },
+    { "sample-warmup", required_argument, NULL, 'V' },
+    { "confidence",    required_argument, NULL, 'L' },
+    { "simpoints",     required_argument, NULL, 'P' },
+    { "result-cache",  required_argument, NULL, 'R' },
+    { "sources",       required_argument, NULL, 'D' },
+    { "capture",       required_argument, NULL, 'O' },
+    { "pc-count",    required_argument, NULL, 'k' },
+    { "help", no_argument,       NULL, 'h' },
+    { NULL,   0,                 NULL, 0   }
+  };
+
+  ReplayConfig config;
+  bool smt = false;
+  unsigned chunks = 0;
+  uint64_t warmup = 1000000;
+  bool check = false;
+  ReplaySampling sampling;
+  double confidence = 0.997;
+  std::string simpoints;
+  std::string result_cache;
+  std::string sources;
+  std::string capture;
+  const char *short_options = "p:s:w:c:n:z:a:k:K:W:CS:U:V:L:P:R:D:O:h";
+  int opt;
+  while ((opt = getopt_long(argc, argv, short_options, options, NULL)) != -1) {
+    switch (opt) {
+      case 'p': config.predictor = optarg; break;
+      case 's': config.globalPredictorSize = std::strtoul(optarg, NULL, 0);
+                break;
+      case 't': smt = true; break;
+      case 'w': config.weightBits = std::strtoul(optarg, NULL, 0); break;
+      case 'c': config.perceptronCount = std::strtoul(optarg, NULL, 0);
+                break;
+      case 'n': config.numTables = std::strtoul(optarg, NULL, 0); break;
+      case 'z': config.tableSize = std::strtoul(optarg, NULL, 0); break;
+      case 'k': config.pcCount = std::strtoul(optarg, NULL, 0); break;
+      case 'K': chunks = std::strtoul(optarg, NULL, 0); break;
+      case 'W': warmup = std::strtoull(optarg, NULL, 0); break;
+      case 'C': check = true; break;
+      case 'P': simpoints = optarg; break;
+      case 'R': result_cache = optarg; break;
+      case 'D': sources = optarg; break;
+      case 'O': capture = optarg; break;
+      case 'S': sampling.period = std::strtoull(optarg, NULL, 0); break;
+      case 'U': sampling.window = std::strtoull(optarg, NULL, 0); break;
+      case 'V': sampling.warmup = std::strtoull(optarg, NULL, 0); break;
+      case 'L': confidence = std::strtod(optarg, NULL);
+                if (!(confidence > 0 && confidence < 1)) usage(argv[0]);
+                break;
+      case 'a':
+        if (std::strcmp(optarg, "fixed") == 0) {
+          config.adaptiveTheta = false;
+        } else if (std::strcmp(optarg, "adaptive") == 0) {
+          config.adaptiveTheta = true;
+        } else if (std::strcmp(optarg, "perceptron") == 0) {
+          config.adaptiveTheta      = true;
+          config.thetaPerPerceptron = true;
+        } else {
+          usage(argv[0]);
+        }
+        break;
+      default:  usage(argv[0]);
+    }
+  }
+  if (optind == argc) usage(argv[0]);
+  if (!result_cache.empty() && (smt || chunks > 0 || sampling.period > 0 ||
+                                !simpoints.empty() || !capture.empty())) {
+    fatal("--result-cache only holds whole replays, not --smt, --chunks, "
+          "--sample, --simpoints or --capture ones\n");
+  }
+
+  if (!capture.empty()) {
+    if (argc - optind != 1 || smt || chunks > 0 || sampling.period > 0 ||
+        !simpoints.empty() || isCapture(argv[optind])) {
+      usage(argv[0]);
+    }
+    replayCapturing(config, argv[optind], capture);
+    return 0;
+  }
+
+  if (smt) {
+    replaySMT(config, argv + optind, argc - optind);
+    return 0;
+  }
+
+  if (!simpoints.empty()) {
+    if (argc - optind != 1) usage(argv[0]);
+    replaySimPoints(config, argv[optind], simpoints, warmup, check);
+    return 0;
+  }
+
+  if (sampling.period > 0) {
+    for (int i = optind; i < argc; i++) {
+      if (i > optind) std::printf("\n");
+      replaySampledTrace(config, argv[i], sampling, confidence, check);
+    }
+    return 0;
+  }
+
+  if (chunks > 0) {
+    for (int i = optind; i < argc; i++) {
+      if (i > optind) std::printf("\n");
+      replayChunked(config, argv[i], chunks, warmup, check);
+    }
+    return 0;
+  }
+
+  // only whole replays of traces are cached, the other modes giving
+  // estimates
+  std::unique_ptr<ReplayResultCache> cache;
+  if (!result_cache.empty()) {
+    cache.reset(new ReplayResultCache(result_cache, sources));
+  }
+
+  for (int i = optind; i < argc; i++) {
+    if (isCapture(argv[i])) {
+      if (i > optind) std::printf("\n");
+      playBack(config, argv[i]);
+      continue;
+    }
+
+    ReplayStats stats;
+    std::string key;
+    if (cache) key = cache->key(config, argv[i]);
+    if (cache && cache->lookup(key, stats)) {
+      std::fprintf(stderr, "%s: cached\n", argv[i]);
+    } else {
+      std::unique_ptr<BPredUnit> bp(createPredictor(config));
+      ReplayEngine engine(bp.get());
+      if (isBinaryTrace(argv[i])) {
+        MappedTrace trace(argv[i]);
+        BinaryTraceReader reader(trace);
+        engine.replayAll(reader, stats);
+      } else {
+        TextTraceReader reader(argv[i]);
+        engine.replayAll(reader, stats);
+      }
+      if (cache) cache->store(key, stats);
+    }
+
+    if (i > optind) std::printf("\n");
+    report(argv[i], config, stats);
+  }
+  return 0;
+}
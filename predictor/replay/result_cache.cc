@@ -0,0 +1,248 @@
+/*****************************************************************
+ * File: result_cache.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Content-addressed cache of run results, keyed by a
+ * hash of everything a result depends on (predictor sources and
+ * parameters, workload, trace), so that unchanged runs are not redone.
+ ****************************************************************/
+
+#include "result_cache.hh"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "base/misc.hh"
+
+namespace
+{
+
+const uint64_t laneMultipliers[2] = {
+  ULL(0x9e3779b97f4a7c15), ULL(0xc2b2ae3d27d4eb4f)
+};
+
+/** splitmix64 finalizer */
+uint64_t
+mix(uint64_t x)
+{
+  x = (x ^ (x >> 30)) * ULL(0xbf58476d1ce4e5b9);
+  x = (x ^ (x >> 27)) * ULL(0x94d049bb133111eb);
+  return x ^ (x >> 31);
+}
+
+/** Sources shared by every perceptron predictor */
+const char *const neuralSources[] = {
+  "history_pool.hh", "history_register.hh", "perceptron_kernel.cc",
+  "perceptron_kernel.hh", "perceptron_weights.hh", "training_threshold.hh",
+  NULL
+};
+
+/** Sources every predictor depends on */
+const char *const commonSources[] = {
+  "bpred_unit.cc", "bpred_unit.hh", "BranchPredictor.py", NULL
+};
+
+/** Own sources of each predictor, the shared ones being added apart */
+struct PredictorSources
+{
+  const char *predictor;
+  bool neural;
+  const char *files[5];
+};
+
+const PredictorSources predictorSources[] = {
+  { "LocalBP",      false, { "2bit_local.cc", "2bit_local.hh", NULL } },
+  { "TournamentBP", false, { "tournament.cc", "tournament.hh", NULL } },
+  { "BiModeBP",     false, { "bi_mode.cc", "bi_mode.hh", NULL } },
+  { "LTAGE",        false, { "ltage.cc", "ltage.hh", NULL } },
+  { "AlwaysBP",     false, { "always.cc", "always.hh", NULL } },
+  { "NeuroBP",      true,  { "neurobranch.cc", "neurobranch.hh", NULL } },
+  { "NeuroPathBP",  true,  { "neuropath.cc", "neuropath.hh", NULL } },
+  { "HashedPerceptronBP", true,
+    { "hashed_perceptron.cc", "hashed_perceptron.hh", NULL } },
+  { "PiecewiseLinearBP", true,
+    { "piecewise.cc", "piecewise.hh", "neuropath.cc", "neuropath.hh",
+      NULL } },
+};
+
+void
+hashFiles(ContentHash &hash, const std::string &dir,
+          const char *const files[], time_t &newest, unsigned *found)
+{
+  for (size_t i = 0; files[i]; i++) {
+    time_t mtime;
+    hash.add(std::string(files[i]));
+    if (!hash.addFile(dir + "/" + files[i], &mtime)) continue;
+    if (mtime > newest) newest = mtime;
+    if (found) (*found)++;
+  }
+}
+
+} // anonymous namespace
+
+ContentHash::ContentHash()
+{
+  lanes[0] = ULL(0x6a09e667f3bcc908);
+  lanes[1] = ULL(0xbb67ae8584caa73b);
+}
+
+ContentHash &
+ContentHash::add(const void *data, size_t size)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; i += 8) {
+    uint64_t word = 0;
+    const size_t n = size - i < 8 ? size - i : 8;
+    std::memcpy(&word, bytes + i, n);
+    for (int lane = 0; lane < 2; lane++) {
+      lanes[lane] = (lanes[lane] ^ word) * laneMultipliers[lane];
+      lanes[lane] ^= lanes[lane] >> 29;
+    }
+  }
+  // the length keeps apart blocks padded to the same words
+  for (int lane = 0; lane < 2; lane++) {
+    lanes[lane] = mix(lanes[lane] ^ size ^ lane);
+  }
+  return *this;
+}
+
+ContentHash &
+ContentHash::add(const std::string &value)
+{
+  return add(value.data(), value.size());
+}
+
+ContentHash &
+ContentHash::add(uint64_t value)
+{
+  return add(&value, sizeof(value));
+}
+
+bool
+ContentHash::addFile(const std::string &path, time_t *mtime)
+{
+  FILE *file = std::fopen(path.c_str(), "rb");
+  struct stat info;
+  if (!file || fstat(fileno(file), &info) != 0) {
+    if (file) std::fclose(file);
+    add(std::string("<missing>"));
+    return false;
+  }
+  if (mtime) *mtime = info.st_mtime;
+
+  // read in fixed blocks, so that the hash does not depend on how
+  // much each read returns
+  static const size_t blockSize = 1 << 20;
+  std::vector<char> block(blockSize);
+  uint64_t total = 0;
+  for (;;) {
+    const size_t n = std::fread(block.data(), 1, blockSize, file);
+    if (n > 0) add(block.data(), n);
+    total += n;
+    if (n < blockSize) break;
+  }
+  const bool complete = !std::ferror(file);
+  std::fclose(file);
+  if (!complete) fatal("Could not read %s\n", path.c_str());
+  add(total);
+  return true;
+}
+
+std::string
+ContentHash::digest() const
+{
+  char hex[33];
+  std::snprintf(hex, sizeof(hex), "%016llx%016llx",
+                (unsigned long long)mix(lanes[0]),
+                (unsigned long long)mix(lanes[1]));
+  return hex;
+}
+
+void
+hashPredictorSources(ContentHash &hash, const std::string &dir,
+                     const std::string &predictor, time_t &newest)
+{
+  const size_t count =
+    sizeof(predictorSources) / sizeof(predictorSources[0]);
+  for (size_t p = 0; p < count; p++) {
+    if (predictor != predictorSources[p].predictor) continue;
+
+    unsigned found = 0;
+    hash.add(predictor);
+    hashFiles(hash, dir, predictorSources[p].files, newest, &found);
+    if (found == 0) {
+      fatal("Cannot find the sources of %s in %s\n", predictor.c_str(),
+            dir.c_str());
+    }
+    if (predictorSources[p].neural) {
+      hashFiles(hash, dir, neuralSources, newest, NULL);
+    }
+    hashFiles(hash, dir, commonSources, newest, NULL);
+    return;
+  }
+  fatal("Unknown predictor %s\n", predictor.c_str());
+}
+
+ResultCache::ResultCache(const std::string &dir)
+  : dir(dir)
+{
+  makeDirectory(dir);
+}
+
+std::string
+ResultCache::path(const std::string &key) const
+{
+  return dir + "/" + key.substr(0, 2) + "/" + key;
+}
+
+bool
+ResultCache::lookup(const std::string &key, std::string &value) const
+{
+  std::ifstream in(path(key).c_str());
+  if (!in) return false;
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  value = contents.str();
+  return true;
+}
+
+void
+ResultCache::store(const std::string &key, const std::string &value) const
+{
+  makeDirectory(dir + "/" + key.substr(0, 2));
+
+  // written aside and renamed over, so that a concurrent lookup sees
+  // either no result or the whole of it
+  const std::string final_path = path(key);
+  std::ostringstream temp_path;
+  temp_path << final_path << ".tmp" << getpid() << "."
+            << std::this_thread::get_id();
+  FILE *file = std::fopen(temp_path.str().c_str(), "w");
+  if (!file) fatal("Could not create %s\n", temp_path.str().c_str());
+  const bool written =
+    std::fwrite(value.data(), 1, value.size(), file) == value.size();
+  if (std::fclose(file) != 0 || !written ||
+      std::rename(temp_path.str().c_str(), final_path.c_str()) != 0) {
+    fatal("Could not write %s\n", final_path.c_str());
+  }
+}
+
+void
+makeDirectory(const std::string &path)
+{
+  for (size_t slash = path.find('/', 1); ;
+       slash = path.find('/', slash + 1)) {
+    const std::string prefix = path.substr(0, slash);
+    if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+      fatal("Cannot create %s: %s\n", prefix.c_str(), std::strerror(errno));
+    }
+    if (slash == std::string::npos) break;
+  }
+}
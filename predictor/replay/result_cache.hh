@@ -0,0 +1,96 @@
+/*****************************************************************
+ * File: result_cache.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Content-addressed cache of run results, keyed by a
+ * hash of everything a result depends on (predictor sources and
+ * parameters, workload, trace), so that unchanged runs are not redone:
+ * header file.
+ ****************************************************************/
+
+#ifndef __REPLAY_RESULT_CACHE_HH__
+#define __REPLAY_RESULT_CACHE_HH__
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+/**
+ * Incremental 128-bit hash of a sequence of values and file contents,
+ * as two independent 64-bit lanes over 8-byte words. It tells apart
+ * contents that differ, but is not meant to resist forgery.
+ */
+class ContentHash
+{
+public:
+  ContentHash();
+
+  /** Adds a block of bytes, along with its length */
+  ContentHash &add(const void *data, size_t size);
+
+  /** Adds a string, along with its length */
+  ContentHash &add(const std::string &value);
+
+  /** Adds an integer */
+  ContentHash &add(uint64_t value);
+
+  /**
+   * Adds the contents of a file, or a marker telling it is missing.
+   * @param mtime Set to the modification time of the file, if found.
+   * @return Whether the file could be read.
+   */
+  bool addFile(const std::string &path, time_t *mtime = NULL);
+
+  /** The hash of everything added so far, as 32 hex digits */
+  std::string digest() const;
+
+private:
+  uint64_t lanes[2];
+};
+
+/**
+ * Hashes the source files of a predictor as found in the given
+ * directory (gem5's src/cpu/pred, or the predictor directory of this
+ * repository, which holds the same files), along with the BPredUnit
+ * sources and BranchPredictor.py holding its parameters, exiting if
+ * the predictor is unknown or none of its own sources is found.
+ * @param newest Updated to the modification time of the newest source,
+ * so that a binary built before them can be told apart.
+ */
+void hashPredictorSources(ContentHash &hash, const std::string &dir,
+                          const std::string &predictor, time_t &newest);
+
+/**
+ * Results stored as text, one file per key under a directory, as
+ * <dir>/<first two digits>/<key>. Stores are atomic, so that several
+ * processes may share a cache.
+ */
+class ResultCache
+{
+public:
+  /**
+   * @param dir Directory of the cache, created if need be.
+   */
+  explicit ResultCache(const std::string &dir);
+
+  /**
+   * Looks a result up.
+   * @return Whether the result was found, in which case value is set.
+   */
+  bool lookup(const std::string &key, std::string &value) const;
+
+  /** Stores a result, replacing any previous one */
+  void store(const std::string &key, const std::string &value) const;
+
+private:
+  std::string path(const std::string &key) const;
+
+  std::string dir;
+};
+
+/** Creates a directory, and its parents, if it does not exist yet */
+void makeDirectory(const std::string &path);
+
+#endif
@@ -0,0 +1,452 @@
+/*****************************************************************
+ * File: runner.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Runs the gem5 predictor x executable matrix of
+ * configs/branch/predict.py in parallel, every run in an output
+ * directory of its own, and collects the statistics scraped by
+ * accuracy.py into a single table as the runs finish, skipping the
+ * runs whose result is cached.
+ ****************************************************************/
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/misc.hh"
+#include "result_cache.hh"
+
+namespace
+{
+
+/** Predictors of predict.py, by --pred index (as in settings.py) */
+const char *const predictorNames[] = {
+  "LocalBP", "TournamentBP", "BiModeBP", "LTAGE", "AlwaysBP", "NeuroBP",
+  "NeuroPathBP", "HashedPerceptronBP", "PiecewiseLinearBP"
+};
+
+/** An executable of predict.py and its command line there */
+struct Executable
+{
+  const char *name;
+  const char *command;
+};
+
+/** Executables of predict.py, by --exec index, to be kept in sync */
+const Executable executables[] = {
+  { "ConnCompSmall", "tests/test-progs/predict/graph/connected-components "
+    "--with-gem5=True --with-cmov=True "
+    "tests/test-progs/predict/graph/small.graph" },
+  { "ConnCompMedium", "tests/test-progs/predict/graph/connected-components "
+    "--with-gem5=True --with-cmov=True "
+    "tests/test-progs/predict/graph/medium.graph" },
+  { "ConnCompLarge", "tests/test-progs/predict/graph/connected-components "
+    "--with-gem5=True --with-cmov=True "
+    "tests/test-progs/predict/graph/large.graph" },
+  { "Bubblesort", "tests/test-progs/predict/stanford/Bubblesort" },
+  { "IntMM",      "tests/test-progs/predict/stanford/IntMM" },
+  { "Oscar",      "tests/test-progs/predict/stanford/Oscar" },
+  { "Perm",       "tests/test-progs/predict/stanford/Perm" },
+  { "Puzzle",     "tests/test-progs/predict/stanford/Puzzle" },
+  { "Queens",     "tests/test-progs/predict/stanford/Queens" },
+  { "Quicksort",  "tests/test-progs/predict/stanford/Quicksort" },
+  { "RealMM",     "tests/test-progs/predict/stanford/RealMM" },
+  { "Towers",     "tests/test-progs/predict/stanford/Towers" },
+  { "Treesort",   "tests/test-progs/predict/stanford/Treesort" },
+  { "Primes",     "tests/test-progs/predict/examples/primes" },
+  { "ShellSort",  "tests/test-progs/predict/examples/shell_sort" }
+};
+
+const unsigned predictorCount =
+  sizeof(predictorNames) / sizeof(predictorNames[0]);
+const unsigned executableCount =
+  sizeof(executables) / sizeof(executables[0]);
+
+/** Statistics scraped out of stats.txt, as in accuracy.py */
+const char *const statNames[] = {
+  "condIncorrect", "branchPredindirectMispredicted", "host_seconds"
+};
+const unsigned statCount = sizeof(statNames) / sizeof(statNames[0]);
+
+/** A single gem5 run */
+struct Job
+{
+  unsigned predictor;
+  unsigned executable;
+  std::string outdir;
+  std::chrono::steady_clock::time_point start;
+
+  /** Result cache key of the run */
+  std::string key;
+};
+
+void
+usage(const char *prog)
+{
+  std::fprintf(stderr,
+    "usage: %s [options]\n"
+    "  Runs configs/branch/predict.py for every (predictor, executable)\n"
+    "  pair, from the gem5 root, and writes one tab-separated row per\n"
+    "  run as soon as it is done.\n"
+    "  --isa ISA         gem5 build to run, build/ISA/gem5.opt\n"
+    "                    (default ARM)\n"
+    "  --gem5 PATH       gem5 binary, overriding --isa\n"
+    "  --script PATH     config script (default configs/branch/predict.py)\n"
+    "  --preds LIST      predictor indices of predict.py (default all)\n"
+    "  --execs LIST      executable indices of predict.py (default\n"
+    "                    0-1,3-12, the small and medium graphs and the\n"
+    "                    Stanford programs)\n"
+    "  --jobs N          runs at once (default: one per core)\n"
+    "  --outdir DIR      directory the runs get their own output\n"
+    "                    directory in, DIR/<predictor>_<executable>\n"
+    "                    (default m5runs)\n"
+    "  --cache DIR       also write the per-run files of accuracy.py,\n"
+    "                    DIR/<ISA>/<predictor>_<executable>.txt\n"
+    "  --result-cache DIR\n"
+    "                    cache of run results, keyed by the predictor\n"
+    "                    sources, the config script, the ISA and the\n"
+    "                    executable and its inputs; cached runs are not\n"
+    "                    redone (default m5runs/cache, none to disable)\n"
+    "  --sources DIR     directory the predictor sources are hashed from\n"
+    "                    (default src/cpu/pred)\n"
+    "  --rerun           redo every run, updating the result cache\n"
+    "  --output FILE     write the table to FILE rather than stdout\n"
+    "  LIST is a comma-separated list of indices or ranges, e.g. 0-3,5\n",
+    prog);
+  std::exit(1);
+}
+
+/** Parses a list of indices and ranges, each below count */
+std::vector<unsigned>
+parseIndices(const std::string &list, unsigned count, const char *what)
+{
+  std::vector<unsigned> indices;
+  std::istringstream items(list);
+  std::string item;
+  while (std::getline(items, item, ',')) {
+    unsigned first, last;
+    char dash;
+    std::istringstream range(item);
+    if (!(range >> first)) fatal("Invalid %s list %s\n", what, list.c_str());
+    last = first;
+    if (range >> dash && (dash != '-' || !(range >> last))) {
+      fatal("Invalid %s list %s\n", what, list.c_str());
+    }
+    if (first > last || last >= count) {
+      fatal("Invalid %s range %s, indices go up to %u\n", what,
+            item.c_str(), count - 1);
+    }
+    for (unsigned i = first; i <= last; i++) indices.push_back(i);
+  }
+  return indices;
+}
+
+/**
+ * Starts a gem5 run in its own output directory, its standard output
+ * and error going to simout and simerr there.
+ * @return The pid of the run.
+ */
+pid_t
+launch(const std::string &gem5, const std::string &script, const Job &job)
+{
+  makeDirectory(job.outdir);
+  const std::string outdir_arg = "--outdir=" + job.outdir;
+  const std::string exec_arg = std::to_string(job.executable);
+  const std::string pred_arg = std::to_string(job.predictor);
+  const std::string simout = job.outdir + "/simout";
+  const std::string simerr = job.outdir + "/simerr";
+  const char *argv[] = {
+    gem5.c_str(), outdir_arg.c_str(), script.c_str(),
+    "--exec", exec_arg.c_str(), "--pred", pred_arg.c_str(), NULL
+  };
+
+  pid_t pid = fork();
+  if (pid < 0) fatal("Cannot fork: %s\n", std::strerror(errno));
+  if (pid > 0) return pid;
+
+  // in the child, only async-signal-safe calls until the exec
+  int out = open(simout.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  int err = open(simerr.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out < 0 || err < 0) _exit(126);
+  dup2(out, STDOUT_FILENO);
+  dup2(err, STDERR_FILENO);
+  close(out);
+  close(err);
+  execv(gem5.c_str(), const_cast<char *const *>(argv));
+  _exit(127);
+}
+
+/**
+ * Scrapes the statistics of a finished run out of its stats.txt, the
+ * first line whose name ends in each of statNames.
+ * @return Whether all of them were found.
+ */
+bool
+scrapeStats(const std::string &outdir, std::string values[])
+{
+  std::ifstream stats((outdir + "/stats.txt").c_str());
+  unsigned found = 0;
+  std::string line;
+  while (found < statCount && std::getline(stats, line)) {
+    std::istringstream fields(line);
+    std::string name, value;
+    if (!(fields >> name >> value)) continue;
+    for (unsigned s = 0; s < statCount; s++) {
+      const size_t length = std::strlen(statNames[s]);
+      if (!values[s].empty() || name.size() < length ||
+          name.compare(name.size() - length, length, statNames[s]) != 0 ||
+          (name.size() > length && name[name.size() - length - 1] != '.')) {
+        continue;
+      }
+      values[s] = value;
+      found++;
+    }
+  }
+  return found == statCount;
+}
+
+/**
+ * Result cache key of a run: everything its statistics depend on but
+ * gem5 itself, i.e. the sources of the predictor (and its parameters),
+ * the config script, the ISA and the executable, its arguments and the
+ * input files among them.
+ */
+std::string
+runKey(const std::string &isa, const std::string &sources,
+       const std::string &script, const Job &job, time_t &newest)
+{
+  ContentHash hash;
+  hash.add(std::string("gem5 1")).add(isa);
+  hashPredictorSources(hash, sources, predictorNames[job.predictor],
+                       newest);
+  hash.addFile(script);
+  hash.add((uint64_t)job.executable);
+
+  std::istringstream command(executables[job.executable].command);
+  std::string arg;
+  while (command >> arg) {
+    hash.add(arg);
+    hash.addFile(arg);
+  }
+  return hash.digest();
+}
+
+/**
+ * Writes the table row of a run, as well as its accuracy.py file if
+ * cache is set and the run went through.
+ */
+void
+reportRun(FILE *out, const std::string &cache, const std::string &isa,
+          const Job &job, const std::string &outcome,
+          const std::string values[], double wall,
+          const std::string &outdir)
+{
+  const char *name = predictorNames[job.predictor];
+  const char *exec = executables[job.executable].name;
+  std::fprintf(out, "%s\t%s\t%s\t", name, exec, outcome.c_str());
+  for (unsigned s = 0; s < statCount; s++) {
+    std::fprintf(out, "%s\t", values[s].empty() ? "-" : values[s].c_str());
+  }
+  std::fprintf(out, "%.2f\t%s\n", wall, outdir.c_str());
+  std::fflush(out);
+
+  if (!cache.empty() && (outcome == "ok" || outcome == "cached")) {
+    const std::string path =
+      cache + "/" + isa + "/" + name + "_" + exec + ".txt";
+    FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) fatal("Cannot open %s\n", path.c_str());
+    std::fprintf(file, "conditional : %s\nindirect : %s\nlatency : %s\n",
+                 values[0].c_str(), values[1].c_str(), values[2].c_str());
+    std::fclose(file);
+  }
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    { "isa",    required_argument, NULL, 'i' },
+    { "gem5",   required_argument, NULL, 'g' },
+    { "script", required_argument, NULL, 's' },
+    { "preds",  required_argument, NULL, 'p' },
+    { "execs",  required_argument, NULL, 'e' },
+    { "jobs",   required_argument, NULL, 'j' },
+    { "outdir", required_argument, NULL, 'd' },
+    { "cache",  required_argument, NULL, 'c' },
+    { "result-cache", required_argument, NULL, 'r' },
+    { "sources", required_argument, NULL, 'S' },
+    { "rerun",  no_argument,       NULL, 'R' },
+    { "output", required_argument, NULL, 'o' },
+    { "help",   no_argument,       NULL, 'h' },
+    { NULL,     0,                 NULL, 0   }
+  };
+
+  std::string isa = "ARM";
+  std::string gem5;
+  std::string script = "configs/branch/predict.py";
+  std::string preds = "0-8";
+  std::string execs = "0-1,3-12";
+  unsigned jobs = std::thread::hardware_concurrency();
+  std::string outdir = "m5runs";
+  std::string cache;
+  std::string result_cache;
+  std::string sources = "src/cpu/pred";
+  bool rerun = false;
+  std::string output;
+  int opt;
+  while ((opt = getopt_long(argc, argv, "i:g:s:p:e:j:d:c:r:S:Ro:h", options,
+                            NULL)) != -1) {
+    switch (opt) {
+      case 'i': isa = optarg; break;
+      case 'g': gem5 = optarg; break;
+      case 's': script = optarg; break;
+      case 'p': preds = optarg; break;
+      case 'e': execs = optarg; break;
+      case 'j': jobs = std::strtoul(optarg, NULL, 0); break;
+      case 'd': outdir = optarg; break;
+      case 'c': cache = optarg; break;
+      case 'r': result_cache = optarg; break;
+      case 'S': sources = optarg; break;
+      case 'R': rerun = true; break;
+      case 'o': output = optarg; break;
+      default:  usage(argv[0]);
+    }
+  }
+  if (optind != argc) usage(argv[0]);
+  if (gem5.empty()) gem5 = "build/" + isa + "/gem5.opt";
+  if (jobs == 0) jobs = 1;
+  if (access(gem5.c_str(), X_OK) != 0) {
+    fatal("Cannot run %s, run from the gem5 root\n", gem5.c_str());
+  }
+  if (result_cache.empty()) result_cache = outdir + "/cache";
+  std::unique_ptr<ResultCache> results;
+  if (result_cache != "none") results.reset(new ResultCache(result_cache));
+
+  // the longest runs are not known ahead, so the pairs simply go in
+  // order, executable by executable
+  std::vector<Job> queue;
+  const std::vector<unsigned> pred_list =
+    parseIndices(preds, predictorCount, "predictor");
+  const std::vector<unsigned> exec_list =
+    parseIndices(execs, executableCount, "executable");
+  for (size_t e = 0; e < exec_list.size(); e++) {
+    for (size_t p = 0; p < pred_list.size(); p++) {
+      Job job;
+      job.predictor  = pred_list[p];
+      job.executable = exec_list[e];
+      job.outdir     = outdir + "/" + predictorNames[job.predictor] + "_" +
+                       executables[job.executable].name;
+      queue.push_back(job);
+    }
+  }
+  if (!cache.empty()) makeDirectory(cache + "/" + isa);
+
+  // the keys leave gem5 itself out, so that changing one predictor only
+  // redoes its runs, but the results of a gem5 built before the sources
+  // are not theirs
+  if (results) {
+    time_t newest = 0;
+    for (size_t i = 0; i < queue.size(); i++) {
+      queue[i].key = runKey(isa, sources, script, queue[i], newest);
+    }
+    struct stat info;
+    if (stat(gem5.c_str(), &info) != 0 || info.st_mtime < newest) {
+      fatal("%s is older than the predictor sources in %s, rebuild it\n",
+            gem5.c_str(), sources.c_str());
+    }
+  }
+
+  FILE *out = stdout;
+  if (!output.empty()) {
+    out = std::fopen(output.c_str(), "w");
+    if (!out) fatal("Cannot open %s\n", output.c_str());
+  }
+  std::fprintf(out, "predictor\texecutable\tstatus\tcondIncorrect\t"
+               "indirectMispredicted\thost_seconds\twall_seconds\t"
+               "outdir\n");
+  std::fflush(out);
+
+  auto start = std::chrono::steady_clock::now();
+  std::map<pid_t, Job> running;
+  size_t next = 0, finished = 0, hits = 0;
+  unsigned failed = 0;
+  while (next < queue.size() || !running.empty()) {
+    while (next < queue.size() && running.size() < jobs) {
+      Job &job = queue[next++];
+      std::string cached;
+      if (results && !rerun && results->lookup(job.key, cached)) {
+        std::istringstream lines(cached);
+        std::string values[statCount];
+        for (unsigned s = 0; s < statCount; s++) lines >> values[s];
+        reportRun(out, cache, isa, job, "cached", values, 0, "-");
+        finished++;
+        hits++;
+        continue;
+      }
+      job.start = std::chrono::steady_clock::now();
+      running[launch(gem5, script, job)] = job;
+    }
+    if (running.empty()) continue;
+
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) continue;
+      fatal("waitpid failed: %s\n", std::strerror(errno));
+    }
+    std::map<pid_t, Job>::iterator it = running.find(pid);
+    if (it == running.end()) continue;
+    const Job job = it->second;
+    running.erase(it);
+    finished++;
+    std::chrono::duration<double> wall =
+      std::chrono::steady_clock::now() - job.start;
+
+    // a run counts as done only if gem5 exited cleanly with its stats
+    std::string values[statCount];
+    std::string outcome = "ok";
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      outcome = WIFEXITED(status)
+        ? "exit " + std::to_string(WEXITSTATUS(status))
+        : "signal " + std::to_string(WTERMSIG(status));
+    } else if (!scrapeStats(job.outdir, values)) {
+      outcome = "no stats";
+    }
+    if (outcome != "ok") failed++;
+    if (outcome == "ok" && results) {
+      results->store(job.key, values[0] + "\n" + values[1] + "\n" +
+                     values[2] + "\n");
+    }
+
+    reportRun(out, cache, isa, job, outcome, values, wall.count(),
+              job.outdir);
+    std::fprintf(stderr, "[%zu/%zu] %s on %s: %s\n", finished,
+                 queue.size(), predictorNames[job.predictor],
+                 executables[job.executable].name, outcome.c_str());
+  }
+  if (out != stdout) std::fclose(out);
+
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  std::fprintf(stderr, "%zu runs (%zu cached, %u failed) on %u jobs in "
+               "%.2f s\n", queue.size(), hits, failed, jobs, elapsed.count());
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,23 @@
+/*****************************************************************
+ * File: bitfield.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's base/bitfield.hh (only the
+ * helpers used by the predictors).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_BASE_BITFIELD_HH__
+#define __REPLAY_SHIM_BASE_BITFIELD_HH__
+
+#include "base/types.hh"
+
+/**
+ * Generate a 64-bit mask of 'nbits' 1s, right justified.
+ */
+inline uint64_t
+mask(int nbits)
+{
+  return (nbits == 64) ? (uint64_t)-1LL : (ULL(1) << nbits) - 1;
+}
+
+#endif
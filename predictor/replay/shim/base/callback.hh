@@ -0,0 +1,34 @@
+/*****************************************************************
+ * File: callback.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's base/callback.hh, wrapping a
+ * member function into a callback object.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_BASE_CALLBACK_HH__
+#define __REPLAY_SHIM_BASE_CALLBACK_HH__
+
+class Callback
+{
+public:
+  virtual ~Callback() { }
+
+  virtual void process() = 0;
+};
+
+template <class T, void (T::* F)()>
+class MakeCallback : public Callback
+{
+public:
+  MakeCallback(T *object, bool auto_delete = false)
+    : object(object)
+  { }
+
+  void process() { (object->*F)(); }
+
+private:
+  T *object;
+};
+
+#endif
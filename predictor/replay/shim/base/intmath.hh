@@ -0,0 +1,46 @@
+/*****************************************************************
+ * File: intmath.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's base/intmath.hh (only the
+ * helpers used by the predictors).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_BASE_INTMATH_HH__
+#define __REPLAY_SHIM_BASE_INTMATH_HH__
+
+#include "base/types.hh"
+
+template <class T>
+inline int
+floorLog2(T x)
+{
+  int y = 0;
+  while (x >>= 1) y++;
+  return y;
+}
+
+template <class T>
+inline int
+ceilLog2(const T &n)
+{
+  if (n == 1) return 0;
+  return floorLog2(n - (T)1) + 1;
+}
+
+template <class T>
+inline bool
+isPowerOf2(const T &n)
+{
+  return n != 0 && (n & (n - 1)) == 0;
+}
+
+template <class T, class U>
+inline T
+roundUp(const T &val, const U &align)
+{
+  T mask = (T)align - 1;
+  return (val + mask) & ~mask;
+}
+
+#endif
@@ -0,0 +1,36 @@
+/*****************************************************************
+ * File: misc.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's base/misc.hh error reporting,
+ * printing to stderr and exiting the replay tool.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_BASE_MISC_HH__
+#define __REPLAY_SHIM_BASE_MISC_HH__
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+
+#define fatal(...)                              \
+  do {                                          \
+    std::fprintf(stderr, "fatal: ");            \
+    std::fprintf(stderr, __VA_ARGS__);          \
+    std::exit(1);                               \
+  } while (0)
+
+#define panic(...)                              \
+  do {                                          \
+    std::fprintf(stderr, "panic: ");            \
+    std::fprintf(stderr, __VA_ARGS__);          \
+    std::abort();                               \
+  } while (0)
+
+#define warn(...)                               \
+  do {                                          \
+    std::fprintf(stderr, "warn: ");             \
+    std::fprintf(stderr, __VA_ARGS__);          \
+  } while (0)
+
+#endif
@@ -0,0 +1,14 @@
+/*****************************************************************
+ * File: trace.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's base/trace.hh. Debug printing
+ * is compiled out of the replay tool.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_BASE_TRACE_HH__
+#define __REPLAY_SHIM_BASE_TRACE_HH__
+
+#define DPRINTF(...) do { } while (0)
+
+#endif
@@ -0,0 +1,25 @@
+/*****************************************************************
+ * File: types.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's base/types.hh so that the
+ * predictors can be compiled outside of the simulator for replay.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_BASE_TYPES_HH__
+#define __REPLAY_SHIM_BASE_TYPES_HH__
+
+#include <cstdint>
+
+/** Constructs a 64-bit unsigned literal, as in gem5 */
+#define ULL(N) ((uint64_t)N##ULL)
+
+/** Address type, matching the simulator's definition */
+typedef uint64_t Addr;
+
+/** Hardware thread identifier, matching the simulator's definition */
+typedef int16_t ThreadID;
+
+const ThreadID InvalidThreadID = -1;
+
+#endif
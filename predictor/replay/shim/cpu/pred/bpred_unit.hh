@@ -0,0 +1,58 @@
+/*****************************************************************
+ * File: bpred_unit.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Minimal stand-in for gem5's BPredUnit. Only the
+ * direction predictor interface is kept (no BTB, RAS or indirect
+ * predictor) since the replay engine drives the predictors
+ * directly from a recorded branch stream.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_CPU_PRED_BPRED_UNIT_HH__
+#define __REPLAY_SHIM_CPU_PRED_BPRED_UNIT_HH__
+
+#include "base/misc.hh"
+#include "base/types.hh"
+#include "params/BranchPredictor.hh"
+
+class BPredUnit
+{
+public:
+  typedef BranchPredictorParams Params;
+
+  BPredUnit(const Params *p)
+    : numThreads(p->numThreads),
+      instShiftAmt(p->instShiftAmt)
+  { }
+
+  virtual ~BPredUnit() { }
+
+  virtual void uncondBranch(ThreadID tid, Addr pc, void * &bp_history) = 0;
+
+  virtual bool lookup(ThreadID tid, Addr instPC, void * &bp_history) = 0;
+
+  virtual void btbUpdate(ThreadID tid, Addr instPC, void * &bp_history) = 0;
+
+  virtual void update(ThreadID tid, Addr instPC, bool taken,
+                      void *bp_history, bool squashed) = 0;
+
+  virtual void squash(ThreadID tid, void *bp_history) = 0;
+
+  virtual unsigned getGHR(ThreadID tid, void *bp_history) const { return 0; }
+
+  /**
+   * Number of times the predictor trained so far, for the replay
+   * statistics. Not in gem5's BPredUnit: the perceptron predictors
+   * define their own trainedBranches(), overriding this one only here.
+   */
+  virtual uint64_t trainedBranches() const { return 0; }
+
+protected:
+  /** Number of the threads for which the branch history is maintained. */
+  const unsigned numThreads;
+
+  /** Number of bits to shift instructions by for predictor addresses. */
+  const unsigned instShiftAmt;
+};
+
+#endif
@@ -0,0 +1,9 @@
+/*****************************************************************
+ * File: capture.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Forwards the gem5 include path to the predictor
+ * header kept at the top of the predictor directory.
+ ****************************************************************/
+
+#include "../../../../capture.hh"
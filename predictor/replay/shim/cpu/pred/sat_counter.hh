@@ -0,0 +1,39 @@
+/*****************************************************************
+ * File: sat_counter.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's saturating counter.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_CPU_PRED_SAT_COUNTER_HH__
+#define __REPLAY_SHIM_CPU_PRED_SAT_COUNTER_HH__
+
+#include <cstdint>
+
+class SatCounter
+{
+public:
+  SatCounter() : initialVal(0), maxVal(0), counter(0) { }
+
+  SatCounter(unsigned bits, uint8_t initial_val = 0)
+    : initialVal(initial_val), maxVal((1 << bits) - 1),
+      counter(initial_val)
+  { }
+
+  void setBits(unsigned bits) { maxVal = (1 << bits) - 1; }
+
+  void reset() { counter = initialVal; }
+
+  void increment() { if (counter < maxVal) ++counter; }
+
+  void decrement() { if (counter > 0) --counter; }
+
+  uint8_t read() const { return counter; }
+
+private:
+  uint8_t initialVal;
+  uint8_t maxVal;
+  uint8_t counter;
+};
+
+#endif
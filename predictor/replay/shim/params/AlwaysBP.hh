@@ -0,0 +1,28 @@
+/*****************************************************************
+ * File: AlwaysBP.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hand-written equivalent of the generated AlwaysBP
+ * params struct (see BranchPredictor.py).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_PARAMS_ALWAYSBP_HH__
+#define __REPLAY_SHIM_PARAMS_ALWAYSBP_HH__
+
+#include "params/BranchPredictor.hh"
+
+class AlwaysBP;
+
+struct AlwaysBPParams : public BranchPredictorParams
+{
+  AlwaysBPParams()
+    : localPredictorSize(2048), localCtrBits(2)
+  { }
+
+  AlwaysBP *create();
+
+  unsigned localPredictorSize;
+  unsigned localCtrBits;
+};
+
+#endif
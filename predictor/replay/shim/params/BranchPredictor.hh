@@ -0,0 +1,23 @@
+/*****************************************************************
+ * File: BranchPredictor.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hand-written equivalent of the params struct that
+ * gem5 generates from BranchPredictor.py. Defaults match the
+ * Python declarations.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_PARAMS_BRANCHPREDICTOR_HH__
+#define __REPLAY_SHIM_PARAMS_BRANCHPREDICTOR_HH__
+
+struct BranchPredictorParams
+{
+  BranchPredictorParams()
+    : numThreads(1), instShiftAmt(2)
+  { }
+
+  unsigned numThreads;
+  unsigned instShiftAmt;
+};
+
+#endif
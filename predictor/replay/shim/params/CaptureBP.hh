@@ -0,0 +1,31 @@
+/*****************************************************************
+ * File: CaptureBP.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hand-written equivalent of the generated CaptureBP
+ * params struct (see BranchPredictor.py).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_PARAMS_CAPTUREBP_HH__
+#define __REPLAY_SHIM_PARAMS_CAPTUREBP_HH__
+
+#include <string>
+
+#include "params/BranchPredictor.hh"
+
+class BPredUnit;
+class CaptureBP;
+
+struct CaptureBPParams : public BranchPredictorParams
+{
+  CaptureBPParams()
+    : predictor(NULL), captureFile("bpcalls.bin")
+  { }
+
+  CaptureBP *create();
+
+  BPredUnit *predictor;
+  std::string captureFile;
+};
+
+#endif
@@ -0,0 +1,33 @@
+/*****************************************************************
+ * File: HashedPerceptronBP.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hand-written equivalent of the generated
+ * HashedPerceptronBP params struct (see BranchPredictor.py).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_PARAMS_HASHEDPERCEPTRONBP_HH__
+#define __REPLAY_SHIM_PARAMS_HASHEDPERCEPTRONBP_HH__
+
+#include "params/BranchPredictor.hh"
+
+class HashedPerceptronBP;
+
+struct HashedPerceptronBPParams : public BranchPredictorParams
+{
+  HashedPerceptronBPParams()
+    : globalPredictorSize(256), numTables(8), tableSize(1024),
+      weightBits(8), adaptiveTheta(false), thetaPerPerceptron(false)
+  { }
+
+  HashedPerceptronBP *create();
+
+  unsigned globalPredictorSize;
+  unsigned numTables;
+  unsigned tableSize;
+  unsigned weightBits;
+  bool adaptiveTheta;
+  bool thetaPerPerceptron;
+};
+
+#endif
@@ -0,0 +1,34 @@
+/*****************************************************************
+ * File: NeuroBP.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hand-written equivalent of the generated NeuroBP
+ * params struct (see BranchPredictor.py).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_PARAMS_NEUROBP_HH__
+#define __REPLAY_SHIM_PARAMS_NEUROBP_HH__
+
+#include "params/BranchPredictor.hh"
+
+class NeuroBP;
+
+struct NeuroBPParams : public BranchPredictorParams
+{
+  NeuroBPParams()
+    : globalPredictorSize(8192), globalCtrBits(2), weightBits(8),
+      perceptronCount(20), adaptiveTheta(false),
+      thetaPerPerceptron(false)
+  { }
+
+  NeuroBP *create();
+
+  unsigned globalPredictorSize;
+  unsigned globalCtrBits;
+  unsigned weightBits;
+  unsigned perceptronCount;
+  bool adaptiveTheta;
+  bool thetaPerPerceptron;
+};
+
+#endif
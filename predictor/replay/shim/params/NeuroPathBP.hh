@@ -0,0 +1,34 @@
+/*****************************************************************
+ * File: NeuroPathBP.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hand-written equivalent of the generated NeuroPathBP
+ * params struct (see BranchPredictor.py).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_PARAMS_NEUROPATHBP_HH__
+#define __REPLAY_SHIM_PARAMS_NEUROPATHBP_HH__
+
+#include "params/BranchPredictor.hh"
+
+class NeuroPathBP;
+
+struct NeuroPathBPParams : public BranchPredictorParams
+{
+  NeuroPathBPParams()
+    : globalPredictorSize(8192), globalCtrBits(2), weightBits(8),
+      perceptronCount(10), adaptiveTheta(false),
+      thetaPerPerceptron(false)
+  { }
+
+  NeuroPathBP *create();
+
+  unsigned globalPredictorSize;
+  unsigned globalCtrBits;
+  unsigned weightBits;
+  unsigned perceptronCount;
+  bool adaptiveTheta;
+  bool thetaPerPerceptron;
+};
+
+#endif
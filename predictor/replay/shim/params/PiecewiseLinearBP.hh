@@ -0,0 +1,30 @@
+/*****************************************************************
+ * File: PiecewiseLinearBP.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Hand-written equivalent of the generated
+ * PiecewiseLinearBP params struct (see BranchPredictor.py).
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_PARAMS_PIECEWISELINEARBP_HH__
+#define __REPLAY_SHIM_PARAMS_PIECEWISELINEARBP_HH__
+
+#include "params/NeuroPathBP.hh"
+
+class PiecewiseLinearBP;
+
+struct PiecewiseLinearBPParams : public NeuroPathBPParams
+{
+  PiecewiseLinearBPParams()
+    : pcCount(8)
+  {
+    globalPredictorSize = 64;
+    perceptronCount     = 64;
+  }
+
+  PiecewiseLinearBP *create();
+
+  unsigned pcCount;
+};
+
+#endif
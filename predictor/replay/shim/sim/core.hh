@@ -0,0 +1,21 @@
+/*****************************************************************
+ * File: core.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Stand-in for gem5's sim/core.hh exit callbacks. The
+ * replay tool deletes its predictors itself, so the callbacks are
+ * dropped rather than run on exit, when their objects are gone.
+ ****************************************************************/
+
+#ifndef __REPLAY_SHIM_SIM_CORE_HH__
+#define __REPLAY_SHIM_SIM_CORE_HH__
+
+#include "base/callback.hh"
+
+inline void
+registerExitCallback(Callback *callback)
+{
+  delete callback;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*****************************************************************
+ * File: simpoint.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Command line driver picking SimPoint-style
+ * representative intervals of a binary branch trace, to be replayed
+ * alone with replay --simpoints.
+ ****************************************************************/
+
+#include <getopt.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "phases.hh"
+#include "trace.hh"
+
+namespace
+{
+
+void
+usage(const char *prog)
+{
+  std::fprintf(stderr,
+    "usage: %s [options] trace.bt output.simpoints\n"
+    "  --interval N      instructions per interval (default 10000000)\n"
+    "  --dims N          dimensions the basic block vectors are\n"
+    "                    projected to (default 15)\n"
+    "  --max-k N         largest number of clusters tried (default 10)\n"
+    "  --seeds N         k-means restarts per number of clusters\n"
+    "                    (default 5)\n"
+    "  --bic F           pick the fewest clusters whose BIC reaches this\n"
+    "                    fraction of the range of BICs (default 0.9)\n",
+    prog);
+  std::exit(1);
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    { "interval", required_argument, NULL, 'i' },
+    { "dims",     required_argument, NULL, 'd' },
+    { "max-k",    required_argument, NULL, 'k' },
+    { "seeds",    required_argument, NULL, 'r' },
+    { "bic",      required_argument, NULL, 'b' },
+    { "help",     no_argument,       NULL, 'h' },
+    { NULL,       0,                 NULL, 0   }
+  };
+
+  uint64_t interval = 10000000;
+  unsigned dimensions = 15;
+  PhaseOptions phase_options;
+  int opt;
+  while ((opt = getopt_long(argc, argv, "i:d:k:r:b:h", options, NULL)) != -1) {
+    switch (opt) {
+      case 'i': interval = std::strtoull(optarg, NULL, 0); break;
+      case 'd': dimensions = std::strtoul(optarg, NULL, 0); break;
+      case 'k': phase_options.maxK = std::strtoul(optarg, NULL, 0); break;
+      case 'r': phase_options.seeds = std::strtoul(optarg, NULL, 0); break;
+      case 'b': phase_options.bicThreshold = std::strtod(optarg, NULL);
+                break;
+      default:  usage(argv[0]);
+    }
+  }
+  if (argc - optind != 2 || interval == 0 || dimensions == 0 ||
+      phase_options.maxK == 0) {
+    usage(argv[0]);
+  }
+
+  MappedTrace trace(argv[optind]);
+  std::vector<TraceInterval> intervals = splitIntervals(trace, interval);
+  std::vector<std::vector<double> > vectors =
+    basicBlockVectors(trace, intervals, dimensions);
+  Clustering clustering;
+  std::vector<SimPoint> points =
+    pickSimPoints(vectors, intervals, phase_options, clustering);
+  writeSimPoints(argv[optind + 1], points);
+
+  std::printf("intervals : %zu\n", intervals.size());
+  std::printf("clusters : %zu\n", clustering.centers.size());
+  std::printf("bic : %.2f\n", clustering.bic);
+  uint64_t instructions = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    instructions += points[i].range.instructions;
+    std::printf("simpoint : %llu %.4f\n",
+                (unsigned long long)points[i].interval, points[i].weight);
+  }
+  std::printf("simulated_fraction : %.4f\n", trace.instructions()
+              ? (double)instructions / trace.instructions() : 0.0);
+  return 0;
+}
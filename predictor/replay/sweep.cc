@@ -0,0 +1,529 @@
+/*****************************************************************
+ * File: sweep.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Command line driver replaying recorded branch traces
+ * through many predictor configurations at once, in parallel on a
+ * work-stealing thread pool, and tabulating the results.
+ ****************************************************************/
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "base/misc.hh"
+#include "engine.hh"
+#include "lockstep.hh"
+#include "trace.hh"
+#include "work_stealing_pool.hh"
+
+namespace
+{
+
+void
+usage(const char *prog)
+{
+  std::fprintf(stderr,
+    "usage: %s [options] trace...\n"
+    "  Replays every trace through every configuration and writes one\n"
+    "  tab-separated row per (configuration, trace) pair, plus a merged\n"
+    "  row per configuration when there are several traces.\n"
+    "  The configurations are the lines of --configs (or a single\n"
+    "  default configuration) crossed with every list given below.\n"
+    "  --configs FILE      one configuration per line, as key=value\n"
+    "                      pairs using the option names below, e.g.\n"
+    "                      \"pred=NeuroPathBP size=256 theta=adaptive\"\n"
+    "  --pred LIST         predictors (see replay --help)\n"
+    "  --size LIST         globalPredictorSize values\n"
+    "  --weight-bits LIST  weightBits values\n"
+    "  --perceptrons LIST  perceptronCount values\n"
+    "  --pc-count LIST     pcCount values (PiecewiseLinearBP)\n"
+    "  --tables LIST       numTables values (HashedPerceptronBP)\n"
+    "  --table-size LIST   tableSize values (HashedPerceptronBP)\n"
+    "  --theta LIST        fixed, adaptive and/or perceptron\n"
+    "  --threads N         worker threads (default: one per core)\n"
+    "  --lockstep N        replay up to N NeuroBP configurations at once\n"
+    "                      per pass over a trace, sharing its decoding\n"
+    "                      and history (ns_per_branch is then the pass\n"
+    "                      time split between them)\n"
+    "  --chunks K          replay every other (configuration, binary\n"
+    "                      trace) pair as K chunks in parallel, each\n"
+    "                      warmed up on the end of the previous one\n"
+    "                      (see replay --chunks)\n"
+    "  --warmup N          warmup records per chunk (default 1000000)\n"
+    "  --halving ETA       successive halving: replay every configuration\n"
+    "                      on a prefix of each (binary) trace, keep the\n"
+    "                      best 1/ETA of them by MPKI and go on with those\n"
+    "                      over a prefix ETA times longer, until the\n"
+    "                      traces are done; a rung column tells how far\n"
+    "                      each configuration went\n"
+    "  --min-prefix N      records of the first prefix (default 1000000)\n"
+    "  --result-cache DIR  look whole replays up in a result cache (see\n"
+    "                      replay --result-cache) rather than redo them,\n"
+    "                      and store the new ones\n"
+    "  --sources DIR       predictor directory the cache keys hash the\n"
+    "                      sources of (default: above the sweep binary)\n"
+    "  --output FILE       write the table to FILE rather than stdout\n"
+    "  LIST is a comma-separated list of values\n", prog);
+  std::exit(1);
+}
+
+unsigned
+parseUnsigned(const std::string &key, const std::string &value)
+{
+  char *end;
+  unsigned long parsed = std::strtoul(value.c_str(), &end, 0);
+  if (value.empty() || *end != '\0') {
+    fatal("Invalid value %s for %s\n", value.c_str(), key.c_str());
+  }
+  return parsed;
+}
+
+/** Sets one parameter of a configuration, exiting if it is invalid */
+void
+setParameter(ReplayConfig &config, const std::string &key,
+             const std::string &value)
+{
+  if (key == "pred") {
+    config.predictor = value;
+  } else if (key == "size") {
+    config.globalPredictorSize = parseUnsigned(key, value);
+  } else if (key == "weight-bits") {
+    config.weightBits = parseUnsigned(key, value);
+  } else if (key == "perceptrons") {
+    config.perceptronCount = parseUnsigned(key, value);
+  } else if (key == "pc-count") {
+    config.pcCount = parseUnsigned(key, value);
+  } else if (key == "tables") {
+    config.numTables = parseUnsigned(key, value);
+  } else if (key == "table-size") {
+    config.tableSize = parseUnsigned(key, value);
+  } else if (key == "theta") {
+    if (value == "fixed" || value == "adaptive" || value == "perceptron") {
+      config.adaptiveTheta      = value != "fixed";
+      config.thetaPerPerceptron = value == "perceptron";
+    } else {
+      fatal("Invalid value %s for theta\n", value.c_str());
+    }
+  } else {
+    fatal("Unknown parameter %s\n", key.c_str());
+  }
+}
+
+/** Reads the configurations of a --configs file */
+std::vector<ReplayConfig>
+readConfigs(const std::string &filename)
+{
+  std::ifstream in(filename.c_str());
+  if (!in) fatal("Cannot open %s\n", filename.c_str());
+
+  std::vector<ReplayConfig> configs;
+  std::string line;
+  while (std::getline(in, line)) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string field;
+    ReplayConfig config;
+    bool any = false;
+    while (fields >> field) {
+      size_t equals = field.find('=');
+      if (equals == std::string::npos) {
+        fatal("Expected key=value in %s, got %s\n", filename.c_str(),
+              field.c_str());
+      }
+      setParameter(config, field.substr(0, equals),
+                   field.substr(equals + 1));
+      any = true;
+    }
+    if (any) configs.push_back(config);
+  }
+  return configs;
+}
+
+/** Crosses every configuration with the values of one parameter */
+std::vector<ReplayConfig>
+cross(const std::vector<ReplayConfig> &configs, const std::string &key,
+      const std::string &values)
+{
+  std::vector<ReplayConfig> crossed;
+  for (size_t i = 0; i < configs.size(); i++) {
+    std::istringstream list(values);
+    std::string value;
+    while (std::getline(list, value, ',')) {
+      ReplayConfig config = configs[i];
+      setParameter(config, key, value);
+      crossed.push_back(config);
+    }
+  }
+  return crossed;
+}
+
+const char *
+thetaName(const ReplayConfig &config)
+{
+  if (!config.adaptiveTheta) return "fixed";
+  return config.thetaPerPerceptron ? "perceptron" : "adaptive";
+}
+
+/**
+ * Successive halving over binary traces: every configuration still in
+ * the running replays each trace on to the current prefix, on its own
+ * predictor kept from one rung to the next, after which only the best
+ * 1/eta of them by MPKI (over all the traces) go on to a prefix eta
+ * times longer, until a rung covers the whole traces.
+ * @param results Counts of every (configuration, trace) pair over the
+ * prefix it reached, filled in.
+ * @param rungs Last rung each configuration was replayed in, the last
+ * rung having covered the whole traces.
+ */
+void
+replayHalving(const std::vector<ReplayConfig> &configs,
+              const std::vector<std::unique_ptr<MappedTrace> > &mapped,
+              WorkStealingPool &pool, unsigned eta, uint64_t min_prefix,
+              std::vector<ReplayStats> &results,
+              std::vector<unsigned> &rungs)
+{
+  const size_t traces = mapped.size();
+  std::vector<std::unique_ptr<BPredUnit> > predictors(results.size());
+  std::vector<ReplayEngine> engines;
+  for (size_t i = 0; i < results.size(); i++) {
+    predictors[i].reset(createPredictor(configs[i / traces]));
+    engines.push_back(ReplayEngine(predictors[i].get()));
+  }
+
+  std::vector<size_t> running(configs.size());
+  for (size_t c = 0; c < configs.size(); c++) running[c] = c;
+  std::vector<uint64_t> done(traces, 0), end(traces);
+  const uint64_t unbounded = std::numeric_limits<uint64_t>::max();
+  uint64_t prefix = std::max<uint64_t>(min_prefix, 1);
+  for (unsigned rung = 0; ; rung++) {
+    // a single configuration left goes straight to the end
+    if (running.size() == 1) prefix = unbounded;
+    bool last = true;
+    for (size_t t = 0; t < traces; t++) {
+      end[t] = std::min(prefix, mapped[t]->records());
+      if (end[t] < mapped[t]->records()) last = false;
+    }
+
+    for (size_t i = 0; i < running.size(); i++) {
+      for (size_t t = 0; t < traces; t++) {
+        const size_t pair = running[i] * traces + t;
+        pool.submit([&, pair, t] {
+          BinaryTraceReader reader(*mapped[t], done[t], end[t]);
+          engines[pair].replayAll(reader, results[pair]);
+        });
+      }
+    }
+    pool.wait();
+    for (size_t i = 0; i < running.size(); i++) rungs[running[i]] = rung;
+    std::fprintf(stderr, "rung %u: %zu configurations on up to %llu "
+                 "records\n", rung, running.size(),
+                 (unsigned long long)*std::max_element(end.begin(),
+                                                       end.end()));
+    if (last) break;
+    done = end;
+
+    // rank by MPKI over all the traces, the earlier configuration first
+    // on a tie
+    std::vector<std::pair<double, size_t> > ranked;
+    for (size_t i = 0; i < running.size(); i++) {
+      ReplayStats merged;
+      for (size_t t = 0; t < traces; t++) {
+        merged.merge(results[running[i] * traces + t]);
+      }
+      ranked.push_back(std::make_pair(merged.mpki(), running[i]));
+    }
+    std::sort(ranked.begin(), ranked.end());
+
+    const size_t kept = (running.size() + eta - 1) / eta;
+    running.clear();
+    for (size_t i = 0; i < ranked.size(); i++) {
+      const size_t c = ranked[i].second;
+      if (i < kept) {
+        running.push_back(c);
+        continue;
+      }
+      for (size_t t = 0; t < traces; t++) predictors[c * traces + t].reset();
+    }
+
+    prefix = prefix > unbounded / eta ? unbounded : prefix * eta;
+  }
+}
+
+void
+writeRow(FILE *out, const ReplayConfig &config, const std::string &trace,
+         const ReplayStats &stats, int rung)
+{
+  // parameters left at 0 keep the default of the predictor
+  std::fprintf(out, "%s\t%u\t%u\t", config.predictor.c_str(),
+               config.globalPredictorSize, config.weightBits);
+  const unsigned defaulted[] = { config.perceptronCount, config.pcCount,
+                                 config.numTables, config.tableSize };
+  for (size_t i = 0; i < sizeof(defaulted) / sizeof(defaulted[0]); i++) {
+    if (defaulted[i]) std::fprintf(out, "%u\t", defaulted[i]);
+    else              std::fprintf(out, "-\t");
+  }
+  std::fprintf(out, "%s\t%s\t%llu\t%llu\t%.4f\t%.4f\t",
+               thetaName(config), trace.c_str(),
+               (unsigned long long)stats.condBranches,
+               (unsigned long long)stats.condIncorrect,
+               stats.accuracy(), stats.mpki());
+  // cached replays took no time
+  if (stats.cached) std::fprintf(out, "-");
+  else              std::fprintf(out, "%.2f", stats.nsPerBranch());
+  if (rung >= 0) std::fprintf(out, "\t%d", rung);
+  std::fprintf(out, "\n");
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    { "configs",     required_argument, NULL, 'f' },
+    { "pred",        required_argument, NULL, 'p' },
+    { "size",        required_argument, NULL, 's' },
+    { "weight-bits", required_argument, NULL, 'w' },
+    { "perceptrons", required_argument, NULL, 'c' },
+    { "pc-count",    required_argument, NULL, 'k' },
+    { "tables",      required_argument, NULL, 'n' },
+    { "table-size",  required_argument, NULL, 'z' },
+    { "theta",       required_argument, NULL, 'a' },
+    { "threads",     required_argument, NULL, 'j' },
+    { "lockstep",    required_argument, NULL, 'l' },
+    { "chunks",      required_argument, NULL, 'K' },
+    { "warmup",      required_argument, NULL, 'W' },
+    { "halving",     required_argument, NULL, 'e' },
+    { "min-prefix",  required_argument, NULL, 'm' },
+    { "result-cache", required_argument, NULL, 'R' },
+    { "sources",     required_argument, NULL, 'D' },
+    { "output",      required_argument, NULL, 'o' },
+    { "help",        no_argument,       NULL, 'h' },
+    { NULL,          0,                 NULL, 0   }
+  };
+
+  std::string configs_file;
+  std::string output;
+  unsigned threads = std::thread::hardware_concurrency();
+  unsigned lockstep = 0;
+  unsigned chunks = 1;
+  uint64_t warmup = 1000000;
+  unsigned halving = 0;
+  uint64_t min_prefix = 1000000;
+  std::string result_cache;
+  std::string sources;
+
+  // parameter lists, crossed in the order they were given
+  std::vector<std::pair<std::string, std::string> > lists;
+  int opt, index;
+  const char *short_options = "f:p:s:w:c:k:n:z:a:j:l:K:W:e:m:R:D:o:h";
+  while ((opt = getopt_long(argc, argv, short_options, options,
+                            &index)) != -1) {
+    switch (opt) {
+      case 'f': configs_file = optarg; break;
+      case 'j': threads = parseUnsigned("threads", optarg); break;
+      case 'l': lockstep = parseUnsigned("lockstep", optarg); break;
+      case 'K': chunks = std::max(parseUnsigned("chunks", optarg), 1u);
+                break;
+      case 'W': warmup = std::strtoull(optarg, NULL, 0); break;
+      case 'e': halving = parseUnsigned("halving", optarg); break;
+      case 'm': min_prefix = std::strtoull(optarg, NULL, 0); break;
+      case 'R': result_cache = optarg; break;
+      case 'D': sources = optarg; break;
+      case 'o': output = optarg; break;
+      case 'p': case 's': case 'w': case 'c': case 'k': case 'n': case 'z':
+      case 'a':
+        for (index = 0; options[index].val != opt; index++) { }
+        lists.push_back(std::make_pair(std::string(options[index].name),
+                                       std::string(optarg)));
+        break;
+      default:  usage(argv[0]);
+    }
+  }
+  if (optind == argc) usage(argv[0]);
+  if (halving == 1) fatal("--halving needs ETA of at least 2\n");
+  if (halving && (lockstep || chunks > 1)) {
+    fatal("--halving cannot be combined with --lockstep or --chunks\n");
+  }
+  if (!result_cache.empty() && (halving || chunks > 1)) {
+    fatal("--result-cache only holds whole replays, not --halving or "
+          "--chunks ones\n");
+  }
+
+  std::vector<ReplayConfig> configs;
+  if (configs_file.empty()) configs.push_back(ReplayConfig());
+  else                      configs = readConfigs(configs_file);
+  for (size_t i = 0; i < lists.size(); i++) {
+    configs = cross(configs, lists[i].first, lists[i].second);
+  }
+
+  // binary traces are mapped once and shared by all their replays
+  std::vector<std::string> traces(argv + optind, argv + argc);
+  std::vector<std::unique_ptr<MappedTrace> > mapped(traces.size());
+  for (size_t t = 0; t < traces.size(); t++) {
+    if (isBinaryTrace(traces[t])) mapped[t].reset(new MappedTrace(traces[t]));
+    else if (halving) fatal("--halving needs binary traces, convert %s "
+                            "first\n", traces[t].c_str());
+  }
+
+  // one task per (configuration, trace) pair, each building its own
+  // predictor, so that tasks share nothing but the mapped traces
+  std::vector<ReplayStats> results(configs.size() * traces.size());
+
+  // with --result-cache, the pairs already replayed are looked up, and
+  // configurations found for every trace are not replayed at all
+  std::unique_ptr<ReplayResultCache> cache;
+  std::vector<std::string> keys(results.size());
+  std::vector<bool> cached(results.size(), false);
+  std::vector<bool> config_cached(configs.size(), false);
+  size_t hits = 0;
+  if (!result_cache.empty()) {
+    cache.reset(new ReplayResultCache(result_cache, sources));
+    for (size_t c = 0; c < configs.size(); c++) {
+      config_cached[c] = true;
+      for (size_t t = 0; t < traces.size(); t++) {
+        const size_t pair = c * traces.size() + t;
+        keys[pair]   = cache->key(configs[c], traces[t]);
+        cached[pair] = cache->lookup(keys[pair], results[pair]);
+        if (cached[pair]) hits++;
+        else              config_cached[c] = false;
+      }
+    }
+  }
+
+  // with --lockstep, the NeuroBP configurations are replayed in groups
+  // of up to that many lanes, one task per group and trace
+  std::vector<std::vector<size_t> > groups;
+  std::vector<bool> grouped(configs.size(), false);
+  if (lockstep > 0) {
+    for (size_t c = 0; c < configs.size(); c++) {
+      if (configs[c].predictor != "NeuroBP" || config_cached[c]) continue;
+      if (groups.empty() || groups.back().size() == lockstep) {
+        groups.push_back(std::vector<size_t>());
+      }
+      groups.back().push_back(c);
+      grouped[c] = true;
+    }
+  }
+
+  // with --chunks, binary traces are further split into chunks
+  // replayed as separate tasks, merged once they are all done
+  std::vector<std::vector<ReplayChunk> > split(traces.size());
+  for (size_t t = 0; t < traces.size(); t++) {
+    if (mapped[t] && chunks > 1) {
+      split[t] = splitTrace(mapped[t]->records(), chunks, warmup);
+    }
+  }
+  std::vector<std::vector<ReplayStats> > chunk_stats(results.size());
+
+  std::vector<unsigned> rungs(configs.size(), 0);
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    WorkStealingPool pool(threads);
+    if (halving) {
+      replayHalving(configs, mapped, pool, halving, min_prefix, results,
+                    rungs);
+    }
+    for (size_t g = 0; g < groups.size(); g++) {
+      for (size_t t = 0; t < traces.size(); t++) {
+        pool.submit([&, g, t] {
+          std::vector<ReplayConfig> lanes;
+          for (size_t i = 0; i < groups[g].size(); i++) {
+            lanes.push_back(configs[groups[g][i]]);
+          }
+          LockstepNeuroBP bp(lanes);
+          if (mapped[t]) {
+            BinaryTraceReader reader(*mapped[t]);
+            bp.replayAll(reader);
+          } else {
+            TextTraceReader reader(traces[t]);
+            bp.replayAll(reader);
+          }
+          for (size_t i = 0; i < groups[g].size(); i++) {
+            results[groups[g][i] * traces.size() + t] = bp.stats(i);
+          }
+        });
+      }
+    }
+    for (size_t c = 0; c < configs.size() && !halving; c++) {
+      if (grouped[c]) continue;
+      for (size_t t = 0; t < traces.size(); t++) {
+        std::vector<ReplayStats> &pieces = chunk_stats[c * traces.size() + t];
+        pieces.resize(split[t].size());
+        for (size_t k = 0; k < split[t].size(); k++) {
+          pool.submit([&, c, t, k] {
+            replayChunk(configs[c], *mapped[t], split[t][k],
+                        chunk_stats[c * traces.size() + t][k]);
+          });
+        }
+        if (!split[t].empty() || cached[c * traces.size() + t]) continue;
+
+        pool.submit([&, c, t] {
+          std::unique_ptr<BPredUnit> bp(createPredictor(configs[c]));
+          ReplayEngine engine(bp.get());
+          ReplayStats &stats = results[c * traces.size() + t];
+          if (mapped[t]) {
+            BinaryTraceReader reader(*mapped[t]);
+            engine.replayAll(reader, stats);
+          } else {
+            TextTraceReader reader(traces[t]);
+            engine.replayAll(reader, stats);
+          }
+        });
+      }
+    }
+    pool.wait();
+    threads = pool.size();
+  }
+  if (cache) {
+    for (size_t i = 0; i < results.size(); i++) {
+      if (!cached[i]) cache->store(keys[i], results[i]);
+    }
+  }
+  for (size_t i = 0; i < results.size(); i++) {
+    for (size_t k = 0; k < chunk_stats[i].size(); k++) {
+      results[i].merge(chunk_stats[i][k]);
+    }
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  FILE *out = stdout;
+  if (!output.empty()) {
+    out = std::fopen(output.c_str(), "w");
+    if (!out) fatal("Cannot open %s\n", output.c_str());
+  }
+  std::fprintf(out, "predictor\tsize\tweightBits\tperceptrons\tpcCount\t"
+               "tables\ttableSize\ttheta\ttrace\tcondBranches\t"
+               "condIncorrect\taccuracy\tmpki\tns_per_branch%s\n",
+               halving ? "\trung" : "");
+  for (size_t c = 0; c < configs.size(); c++) {
+    const int rung = halving ? (int)rungs[c] : -1;
+    ReplayStats merged;
+    for (size_t t = 0; t < traces.size(); t++) {
+      const ReplayStats &stats = results[c * traces.size() + t];
+      writeRow(out, configs[c], traces[t], stats, rung);
+      merged.merge(stats);
+    }
+    if (traces.size() > 1) writeRow(out, configs[c], "all", merged, rung);
+  }
+  if (out != stdout) std::fclose(out);
+
+  std::fprintf(stderr, "%zu replays (%zu cached) on %u threads in %.2f s\n",
+               results.size(), hits, threads, elapsed.count());
+  return 0;
+}
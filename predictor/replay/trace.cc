@@ -0,0 +1,289 @@
+/*****************************************************************
+ * File: trace.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Branch records and readers for the recorded branch
+ * streams that are replayed through the predictors.
+ ****************************************************************/
+
+#include "trace.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "base/misc.hh"
+
+namespace
+{
+
+// column indices of the text dump, mirroring static/settings.py
+const int UOP         = 0;
+const int PC          = 1;
+const int FLAGS       = 5;
+const int BRANCH      = 6;
+const int TARGET      = 11;
+const int MACRO       = 12;
+const int MICRO       = 13;
+const int NUM_COLUMNS = 14;
+
+/**
+ * Splits the line in place on whitespace, returning the number of
+ * columns found (at most NUM_COLUMNS).
+ */
+int
+tokenize(char *line, char *cols[NUM_COLUMNS])
+{
+  int n = 0;
+  char *p = line;
+  while (n < NUM_COLUMNS) {
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '\0' || *p == '\n' || *p == '\r') break;
+    cols[n++] = p;
+    while (*p && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') p++;
+    if (*p == '\0') break;
+    *p++ = '\0';
+  }
+  return n;
+}
+
+BranchKind
+classify(const char *flags, const char *macro, const char *micro)
+{
+  if (flags[0] == 'R')                return BranchCond;
+  if (std::strcmp(macro, "CALL") == 0) return BranchCall;
+  if (std::strcmp(macro, "RET") == 0)  return BranchReturn;
+  if (std::strcmp(micro, "JMP_REG") == 0) return BranchIndirect;
+  return BranchUncond;
+}
+
+} // anonymous namespace
+
+const char binaryTraceMagic[8] = { 'N', 'P', 'B', 'T', 'R', 'A', 'C', 'E' };
+
+const char *
+branchKindName(BranchKind kind)
+{
+  switch (kind) {
+    case BranchCond:     return "cond";
+    case BranchUncond:   return "uncond";
+    case BranchCall:     return "call";
+    case BranchReturn:   return "return";
+    case BranchIndirect: return "indirect";
+  }
+  return "unknown";
+}
+
+TextTraceReader::TextTraceReader(const std::string &filename)
+  : file(filename == "-" ? stdin : std::fopen(filename.c_str(), "r")),
+    instCount(0),
+    instSinceBranch(0),
+    lineNumber(0),
+    filename(filename)
+{
+  if (!file) {
+    fatal("Could not open trace %s\n", filename.c_str());
+  }
+}
+
+TextTraceReader::~TextTraceReader()
+{
+  if (file != stdin) std::fclose(file);
+}
+
+bool
+TextTraceReader::next(BranchRecord &rec)
+{
+  char line[512];
+  char *cols[NUM_COLUMNS];
+
+  while (std::fgets(line, sizeof(line), file)) {
+    lineNumber++;
+    int n = tokenize(line, cols);
+    if (n == 0) continue;
+    if (n < NUM_COLUMNS) {
+      fatal("%s:%llu: expected %d columns, found %d\n", filename.c_str(),
+            (unsigned long long)lineNumber, NUM_COLUMNS, n);
+    }
+
+    // every macro-op starts with micro-op 1
+    if (std::strcmp(cols[UOP], "1") == 0) {
+      instCount++;
+      instSinceBranch++;
+    }
+
+    if (cols[BRANCH][0] == '-') continue;
+
+    rec.pc      = std::strtoull(cols[PC], NULL, 16);
+    rec.target  = std::strtoull(cols[TARGET], NULL, 16);
+    rec.taken   = (cols[BRANCH][0] == 'T');
+    rec.kind    = classify(cols[FLAGS], cols[MACRO], cols[MICRO]);
+    rec.instGap = instSinceBranch;
+    instSinceBranch = 0;
+    return true;
+  }
+  return false;
+}
+
+bool
+isBinaryTrace(const std::string &filename)
+{
+  char magic[sizeof(binaryTraceMagic)];
+  FILE *file = std::fopen(filename.c_str(), "rb");
+  if (!file) return false;
+  bool binary = std::fread(magic, sizeof(magic), 1, file) == 1 &&
+                std::memcmp(magic, binaryTraceMagic, sizeof(magic)) == 0;
+  std::fclose(file);
+  return binary;
+}
+
+BinaryTraceWriter::BinaryTraceWriter(const std::string &filename)
+  : file(std::fopen(filename.c_str(), "wb")),
+    filename(filename)
+{
+  if (!file) {
+    fatal("Could not create trace %s\n", filename.c_str());
+  }
+
+  std::memcpy(header.magic, binaryTraceMagic, sizeof(header.magic));
+  header.version      = binaryTraceVersion;
+  header.recordSize   = sizeof(PackedBranch);
+  header.records      = 0;
+  header.instructions = 0;
+
+  // placeholder, rewritten with the final counts on close
+  if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+    fatal("Could not write to trace %s\n", filename.c_str());
+  }
+  buffer.reserve(4096);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter()
+{
+  if (file) close();
+}
+
+void
+BinaryTraceWriter::write(const BranchRecord &rec)
+{
+  if (rec.instGap > maxInstGap) {
+    fatal("%s: %u instructions since the previous branch, more than the "
+          "%u a record holds\n", filename.c_str(), rec.instGap, maxInstGap);
+  }
+  buffer.push_back(packBranch(rec));
+  header.records++;
+  header.instructions += rec.instGap;
+  if (buffer.size() == buffer.capacity()) flush();
+}
+
+void
+BinaryTraceWriter::flush()
+{
+  if (buffer.empty()) return;
+  if (std::fwrite(buffer.data(), sizeof(PackedBranch), buffer.size(), file)
+      != buffer.size()) {
+    fatal("Could not write to trace %s\n", filename.c_str());
+  }
+  buffer.clear();
+}
+
+void
+BinaryTraceWriter::close()
+{
+  flush();
+  if (std::fseek(file, 0, SEEK_SET) != 0 ||
+      std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+      std::fclose(file) != 0) {
+    fatal("Could not finalize trace %s\n", filename.c_str());
+  }
+  file = NULL;
+}
+
+MappedTrace::MappedTrace(const std::string &filename)
+  : filename(filename), base(NULL), length(0), first(NULL)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    fatal("Could not open trace %s\n", filename.c_str());
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(header)) {
+    fatal("%s is not a binary branch trace\n", filename.c_str());
+  }
+  length = st.st_size;
+
+  base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    fatal("Could not map trace %s\n", filename.c_str());
+  }
+  madvise(base, length, MADV_SEQUENTIAL);
+
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, binaryTraceMagic, sizeof(header.magic))) {
+    fatal("%s is not a binary branch trace\n", filename.c_str());
+  }
+  // version 1 only differs in saturating instGap
+  if ((header.version != binaryTraceVersion && header.version != 1) ||
+      header.recordSize != sizeof(PackedBranch)) {
+    fatal("%s: unsupported trace version %u\n", filename.c_str(),
+          header.version);
+  }
+  if (sizeof(header) + header.records * sizeof(PackedBranch) > length) {
+    fatal("%s: trace is truncated\n", filename.c_str());
+  }
+  first = reinterpret_cast<const PackedBranch *>(
+    static_cast<const char *>(base) + sizeof(header));
+}
+
+MappedTrace::~MappedTrace()
+{
+  munmap(base, length);
+}
+
+void
+MappedTrace::release(const PackedBranch *from, const PackedBranch *to) const
+{
+  // only whole pages strictly inside the range can be dropped
+  const uintptr_t page = sysconf(_SC_PAGESIZE);
+  uintptr_t start = ((uintptr_t)from + page - 1) & ~(page - 1);
+  uintptr_t stop  = (uintptr_t)to & ~(page - 1);
+  if (start < stop) {
+    madvise((void *)start, stop - start, MADV_DONTNEED);
+  }
+}
+
+BinaryTraceReader::BinaryTraceReader(const MappedTrace &trace)
+  : trace(trace),
+    cur(trace.begin()),
+    last(trace.end()),
+    released(cur),
+    releaseMark(cur + releaseInterval)
+{ }
+
+BinaryTraceReader::BinaryTraceReader(const MappedTrace &trace,
+                                     uint64_t first, uint64_t last)
+  : trace(trace),
+    cur(trace.begin() + first),
+    last(trace.begin() + last),
+    released(cur),
+    releaseMark(cur + releaseInterval)
+{
+  if (first > last || last > trace.records()) {
+    fatal("Invalid record range [%llu, %llu)\n",
+          (unsigned long long)first, (unsigned long long)last);
+  }
+}
+
+void
+BinaryTraceReader::releaseConsumed()
+{
+  trace.release(released, cur);
+  released    = cur;
+  releaseMark = cur + releaseInterval;
+}
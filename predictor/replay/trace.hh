@@ -0,0 +1,315 @@
+/*****************************************************************
+ * File: trace.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Branch records and readers for the recorded branch
+ * streams that are replayed through the predictors: header file.
+ ****************************************************************/
+
+#ifndef __REPLAY_TRACE_HH__
+#define __REPLAY_TRACE_HH__
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+
+/** Control transfer classes distinguished by the replay engine */
+enum BranchKind
+{
+  BranchCond     = 0, // conditional direct branch
+  BranchUncond   = 1, // unconditional direct jump
+  BranchCall     = 2, // direct or indirect call
+  BranchReturn   = 3, // return
+  BranchIndirect = 4  // indirect (register) jump
+};
+
+/** Printable name of the given branch kind */
+const char *branchKindName(BranchKind kind);
+
+/**
+ * A single branch of the recorded stream. instGap is the number of
+ * instructions retired since the previous branch, including this one,
+ * so that MPKI can be computed without keeping non-branch records.
+ */
+struct BranchRecord
+{
+  Addr pc;
+  Addr target;
+  bool taken;
+  BranchKind kind;
+  unsigned instGap;
+};
+
+/**
+ * On-disk layout of a branch in the binary trace format: two
+ * little-endian 64-bit words, 16 bytes per branch.
+ *   info:   bits  0-47 pc (sign-extended on decode)
+ *           bits 48-63 instGap, low 16 bits
+ *   target: bits  0-47 target (sign-extended on decode)
+ *           bit  48    taken
+ *           bits 49-51 kind
+ *           bits 52-63 instGap, high 12 bits (0 in version 1 traces,
+ *                      whose instGap saturated at 65535)
+ */
+struct PackedBranch
+{
+  uint64_t info;
+  uint64_t target;
+};
+
+/**
+ * Header at the start of a binary trace. The record and instruction
+ * counts are filled in once the whole trace has been written.
+ */
+struct BinaryTraceHeader
+{
+  char     magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  uint64_t records;
+  uint64_t instructions;
+};
+
+/** Magic string opening every binary trace */
+extern const char binaryTraceMagic[8];
+
+/** Current version of the binary trace format */
+const uint32_t binaryTraceVersion = 2;
+
+/** Largest instGap a packed branch holds */
+const unsigned maxInstGap = (1u << 28) - 1;
+
+/**
+ * Packs a branch record into its on-disk layout.
+ * @param rec The branch, whose instGap is at most maxInstGap.
+ */
+inline PackedBranch
+packBranch(const BranchRecord &rec)
+{
+  const uint64_t addrMask = (ULL(1) << 48) - 1;
+
+  PackedBranch packed;
+  packed.info   = (rec.pc & addrMask) |
+                  ((uint64_t)(rec.instGap & 0xffff) << 48);
+  packed.target = (rec.target & addrMask) |
+                  ((uint64_t)rec.taken << 48) |
+                  ((uint64_t)rec.kind  << 49) |
+                  ((uint64_t)(rec.instGap >> 16) << 52);
+  return packed;
+}
+
+/** Unpacks a branch record from its on-disk layout. */
+inline void
+unpackBranch(const PackedBranch &packed, BranchRecord &rec)
+{
+  // shifting up and arithmetically back down restores the
+  // canonical (sign-extended) form of the 48-bit addresses
+  rec.pc      = (Addr)((int64_t)(packed.info << 16) >> 16);
+  rec.target  = (Addr)((int64_t)(packed.target << 16) >> 16);
+  rec.instGap = (unsigned)(packed.info >> 48) |
+                (unsigned)(packed.target >> 52) << 16;
+  rec.taken   = (packed.target >> 48) & 1;
+  rec.kind    = (BranchKind)((packed.target >> 49) & 7);
+}
+
+/**
+ * Whether the given file starts with the binary trace magic string.
+ * @param filename Path to the trace.
+ */
+bool isBinaryTrace(const std::string &filename);
+
+/**
+ * Streams branch records out of the 14-column text dumps found in
+ * static/data (see static/settings.py for the column layout). A row is
+ * a branch when its BRANCH column is not '-'; it is conditional when it
+ * also reads the flags (FLAGS == 'R'), as in static/branch.py.
+ */
+class TextTraceReader
+{
+public:
+  /**
+   * Opens the given text trace, exiting on failure.
+   * @param filename Path to the .trace dump, or "-" for stdin.
+   */
+  TextTraceReader(const std::string &filename);
+
+  ~TextTraceReader();
+
+  /**
+   * Reads the next branch in the trace.
+   * @param rec Record to be filled in.
+   * @return False once the end of the trace has been reached.
+   */
+  bool next(BranchRecord &rec);
+
+  /** Number of instructions (macro-ops) read so far. */
+  uint64_t instructions() const { return instCount; }
+
+private:
+  /** Handle of the open trace */
+  FILE *file;
+
+  /** Instructions read so far */
+  uint64_t instCount;
+
+  /** Instructions read since the last branch */
+  unsigned instSinceBranch;
+
+  /** Current line number, for error reporting */
+  uint64_t lineNumber;
+
+  /** Name of the trace, for error reporting */
+  std::string filename;
+};
+
+/**
+ * Writes branch records in the binary trace format. Records are
+ * buffered and the header is finalized when the writer is closed.
+ */
+class BinaryTraceWriter
+{
+public:
+  /**
+   * Creates (or truncates) the given binary trace, exiting on failure.
+   * @param filename Path to the binary trace.
+   */
+  BinaryTraceWriter(const std::string &filename);
+
+  /** Closes the trace if close() has not been called yet. */
+  ~BinaryTraceWriter();
+
+  /**
+   * Appends a branch to the trace, exiting if its instGap is larger
+   * than a record holds (maxInstGap), which the instruction count of
+   * the header would then disagree with.
+   * @param rec The branch to be written.
+   */
+  void write(const BranchRecord &rec);
+
+  /** Flushes the remaining records and writes the final header. */
+  void close();
+
+  /** Number of records written so far. */
+  uint64_t records() const { return header.records; }
+
+private:
+  /** Writes out the buffered records */
+  void flush();
+
+  FILE *file;
+  std::string filename;
+  BinaryTraceHeader header;
+  std::vector<PackedBranch> buffer;
+};
+
+/**
+ * Read-only memory mapping of a binary trace. The records are decoded
+ * in place, so the mapping is never copied and can be shared by any
+ * number of readers (and threads) at once.
+ */
+class MappedTrace
+{
+public:
+  /**
+   * Maps the given binary trace, exiting if it is not one.
+   * @param filename Path to the binary trace.
+   */
+  MappedTrace(const std::string &filename);
+
+  ~MappedTrace();
+
+  /** First record of the trace. */
+  const PackedBranch *begin() const { return first; }
+
+  /** One past the last record of the trace. */
+  const PackedBranch *end() const { return first + header.records; }
+
+  /** Number of records in the trace, as recorded in its header. */
+  uint64_t records() const { return header.records; }
+
+  /** Number of instructions in the trace, as recorded in its header. */
+  uint64_t instructions() const { return header.instructions; }
+
+  /**
+   * Tells the kernel that the given (already replayed) records will
+   * not be needed again, so their pages stop counting towards RSS.
+   * @param from First record of the range.
+   * @param to One past the last record of the range.
+   */
+  void release(const PackedBranch *from, const PackedBranch *to) const;
+
+private:
+  MappedTrace(const MappedTrace &);
+  MappedTrace &operator=(const MappedTrace &);
+
+  std::string filename;
+  BinaryTraceHeader header;
+
+  /** Start and length of the whole mapping */
+  void *base;
+  size_t length;
+
+  /** First record, right after the header */
+  const PackedBranch *first;
+};
+
+/**
+ * Iterates over a range of records of a mapped trace. No allocation
+ * is done per record; consumed pages are periodically released so that
+ * arbitrarily long traces replay in constant memory.
+ */
+class BinaryTraceReader
+{
+public:
+  /**
+   * Reads the whole trace.
+   * @param trace The mapped trace, which must outlive the reader.
+   */
+  BinaryTraceReader(const MappedTrace &trace);
+
+  /**
+   * Reads records [first, last) of the trace.
+   * @param trace The mapped trace, which must outlive the reader.
+   * @param first Index of the first record to be read.
+   * @param last Index one past the last record to be read.
+   */
+  BinaryTraceReader(const MappedTrace &trace, uint64_t first,
+                    uint64_t last);
+
+  /**
+   * Reads the next branch in the range.
+   * @param rec Record to be filled in.
+   * @return False once the end of the range has been reached.
+   */
+  bool next(BranchRecord &rec)
+  {
+    if (cur == last) return false;
+    if (cur == releaseMark) releaseConsumed();
+    unpackBranch(*cur++, rec);
+    return true;
+  }
+
+  /** Number of records left in the range. */
+  uint64_t remaining() const { return last - cur; }
+
+private:
+  /** Number of records read between two releases of consumed pages */
+  static const size_t releaseInterval = (64 << 20) / sizeof(PackedBranch);
+
+  /** Releases the pages read since the last release */
+  void releaseConsumed();
+
+  const MappedTrace &trace;
+  const PackedBranch *cur;
+  const PackedBranch *last;
+
+  /** Start of the records not released yet */
+  const PackedBranch *released;
+
+  /** Record at which the next release happens */
+  const PackedBranch *releaseMark;
+};
+
+#endif
@@ -0,0 +1,344 @@
+/*****************************************************************
+ * File: tracer.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Native branch tracer for x86-64 Linux: runs a program
+ * (e.g. the Stanford kernels of tests/stanford) under ptrace, single
+ * stepping it, and writes the branches it runs straight into a binary
+ * branch trace, without a simulator.
+ ****************************************************************/
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "tracer only runs x86-64 programs on Linux"
+#endif
+
+#include <getopt.h>
+#include <sys/ptrace.h>
+#include <sys/types.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+#include "base/misc.hh"
+#include "trace.hh"
+
+namespace
+{
+
+/** What an instruction does to the control flow, decoded once */
+struct DecodedInst
+{
+  bool branch;
+  BranchKind kind;
+
+  /** Whether the target is encoded in the instruction */
+  bool direct;
+
+  /** Target of a direct branch */
+  Addr target;
+
+  /** Address of the next instruction, known for direct branches */
+  Addr fallThrough;
+};
+
+/**
+ * Decodes the control transfer, if any, at the start of the given
+ * bytes. Only the prefixes and the opcode (and the ModRM reg field of
+ * group 5) are looked at, which is all it takes to tell the branches
+ * apart; the length of other instructions is not needed, the next
+ * instruction being found by stepping.
+ *   conditional:   Jcc rel8/rel32, JrCXZ, LOOP/LOOPE/LOOPNE
+ *   unconditional: JMP rel8/rel32
+ *   call:          CALL rel32, CALL r/m (FF /2, /3)
+ *   return:        RET, RET imm16, far RET
+ *   indirect:      JMP r/m (FF /4, /5)
+ */
+DecodedInst
+decode(const unsigned char *bytes, Addr pc)
+{
+  DecodedInst inst;
+  inst.branch      = false;
+  inst.kind        = BranchCond;
+  inst.direct      = false;
+  inst.target      = 0;
+  inst.fallThrough = 0;
+
+  // legacy prefixes (operand and address size, lock, rep/bnd, segment
+  // or branch hints), then at most one REX prefix
+  size_t i = 0;
+  while (i < 14) {
+    const unsigned char b = bytes[i];
+    if (b != 0x66 && b != 0x67 && b != 0xf0 && b != 0xf2 && b != 0xf3 &&
+        b != 0x2e && b != 0x3e && b != 0x26 && b != 0x36 && b != 0x64 &&
+        b != 0x65) {
+      break;
+    }
+    i++;
+  }
+  if ((bytes[i] & 0xf0) == 0x40) i++;
+
+  const unsigned char op = bytes[i];
+  int64_t displacement = 0;
+  size_t length = 0;
+  if ((op >= 0x70 && op <= 0x7f) || (op >= 0xe0 && op <= 0xe3)) {
+    inst.kind = BranchCond;
+    length = i + 2;
+    displacement = (int8_t)bytes[i + 1];
+  } else if (op == 0x0f && bytes[i + 1] >= 0x80 && bytes[i + 1] <= 0x8f) {
+    int32_t rel;
+    std::memcpy(&rel, bytes + i + 2, sizeof(rel));
+    inst.kind = BranchCond;
+    length = i + 6;
+    displacement = rel;
+  } else if (op == 0xeb) {
+    inst.kind = BranchUncond;
+    length = i + 2;
+    displacement = (int8_t)bytes[i + 1];
+  } else if (op == 0xe9 || op == 0xe8) {
+    int32_t rel;
+    std::memcpy(&rel, bytes + i + 1, sizeof(rel));
+    inst.kind = op == 0xe8 ? BranchCall : BranchUncond;
+    length = i + 5;
+    displacement = rel;
+  } else if (op == 0xc3 || op == 0xc2 || op == 0xcb || op == 0xca) {
+    inst.branch = true;
+    inst.kind   = BranchReturn;
+    return inst;
+  } else if (op == 0xff) {
+    const unsigned reg = (bytes[i + 1] >> 3) & 7;
+    if (reg == 2 || reg == 3) {
+      inst.branch = true;
+      inst.kind   = BranchCall;
+    } else if (reg == 4 || reg == 5) {
+      inst.branch = true;
+      inst.kind   = BranchIndirect;
+    }
+    return inst;
+  } else {
+    return inst;
+  }
+
+  inst.branch      = true;
+  inst.direct      = true;
+  inst.fallThrough = pc + length;
+  inst.target      = inst.fallThrough + displacement;
+  return inst;
+}
+
+/**
+ * Single steps a traced program, decoding every new instruction
+ * address once, and writes out a record for every branch it runs.
+ */
+class Tracer
+{
+public:
+  Tracer(pid_t pid, BinaryTraceWriter &writer)
+    : instructions(0), pid(pid), writer(writer), gap(0)
+  {
+    std::memset(counts, 0, sizeof(counts));
+  }
+
+  /**
+   * Steps the program until it exits or the given number of
+   * instructions (0 for no limit) has run.
+   * @return The wait status the program ended with, or -1 if it was
+   * stopped at the limit.
+   */
+  int run(uint64_t limit);
+
+  /** Instructions run, and branches of every kind */
+  uint64_t instructions;
+  uint64_t counts[5];
+
+private:
+  /** Current instruction pointer of the program */
+  Addr pc() const;
+
+  /** The decoded instruction at the given address */
+  const DecodedInst &instruction(Addr addr);
+
+  pid_t pid;
+  BinaryTraceWriter &writer;
+
+  /** Instructions run since the last branch */
+  unsigned gap;
+
+  std::unordered_map<Addr, DecodedInst> decoded;
+};
+
+Addr
+Tracer::pc() const
+{
+  struct user_regs_struct regs;
+  if (ptrace(PTRACE_GETREGS, pid, NULL, &regs) != 0) {
+    fatal("Could not read the registers of %d: %s\n", (int)pid,
+          std::strerror(errno));
+  }
+  return regs.rip;
+}
+
+const DecodedInst &
+Tracer::instruction(Addr addr)
+{
+  auto it = decoded.find(addr);
+  if (it != decoded.end()) return it->second;
+
+  // an instruction is at most 15 bytes; the second word may be past
+  // the end of the mapping, in which case it is not part of it. The
+  // rest is padding for the decoder reading past a truncated opcode
+  unsigned char bytes[24];
+  std::memset(bytes, 0, sizeof(bytes));
+  for (int w = 0; w < 2; w++) {
+    errno = 0;
+    const long word = ptrace(PTRACE_PEEKTEXT, pid, addr + 8 * w, NULL);
+    if (errno != 0) {
+      if (w == 0) fatal("Could not read the code at %#llx\n",
+                        (unsigned long long)addr);
+      break;
+    }
+    std::memcpy(bytes + 8 * w, &word, sizeof(word));
+  }
+  return decoded[addr] = decode(bytes, addr);
+}
+
+int
+Tracer::run(uint64_t limit)
+{
+  Addr cur = pc();
+  int signal = 0;
+  for (;;) {
+    const DecodedInst &inst = instruction(cur);
+    const bool delivering = signal != 0;
+    if (ptrace(PTRACE_SINGLESTEP, pid, NULL, (void *)(long)signal) != 0) {
+      fatal("Could not step %d: %s\n", (int)pid, std::strerror(errno));
+    }
+    signal = 0;
+
+    int status;
+    if (waitpid(pid, &status, 0) != pid) {
+      fatal("Could not wait for %d: %s\n", (int)pid, std::strerror(errno));
+    }
+    if (WIFEXITED(status) || WIFSIGNALED(status)) return status;
+
+    // other signals are passed on with the next step; the program did
+    // not get past the instruction, or was sent to a handler
+    const Addr next = pc();
+    if (WSTOPSIG(status) != SIGTRAP) {
+      signal = WSTOPSIG(status);
+      cur = next;
+      continue;
+    }
+    if (delivering) {
+      cur = next;
+      continue;
+    }
+
+    // every iteration of a rep-prefixed instruction traps
+    if (next == cur && !inst.branch) continue;
+
+    instructions++;
+    gap++;
+    if (inst.branch) {
+      BranchRecord rec;
+      rec.pc      = cur;
+      rec.kind    = inst.kind;
+      rec.taken   = inst.kind != BranchCond || next != inst.fallThrough;
+      rec.target  = inst.direct ? inst.target : next;
+      rec.instGap = gap;
+      writer.write(rec);
+      counts[inst.kind]++;
+      gap = 0;
+    }
+    cur = next;
+
+    if (limit > 0 && instructions >= limit) {
+      kill(pid, SIGKILL);
+      waitpid(pid, &status, 0);
+      return -1;
+    }
+  }
+}
+
+void
+usage(const char *prog)
+{
+  std::fprintf(stderr,
+    "usage: %s [options] output.bt program [arguments...]\n"
+    "  --max-instructions N  stop the program after N instructions\n"
+    "                        (default: run it to the end)\n", prog);
+  std::exit(1);
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char **argv)
+{
+  static const struct option options[] = {
+    { "max-instructions", required_argument, NULL, 'n' },
+    { "help",             no_argument,       NULL, 'h' },
+    { NULL,               0,                 NULL, 0   }
+  };
+
+  uint64_t limit = 0;
+  int opt;
+  // stop at the first operand, the options after the program being its
+  while ((opt = getopt_long(argc, argv, "+n:h", options, NULL)) != -1) {
+    switch (opt) {
+      case 'n': limit = std::strtoull(optarg, NULL, 0); break;
+      default:  usage(argv[0]);
+    }
+  }
+  if (argc - optind < 2) usage(argv[0]);
+  char **program = argv + optind + 1;
+
+  BinaryTraceWriter writer(argv[optind]);
+  const pid_t pid = fork();
+  if (pid < 0) fatal("Could not fork: %s\n", std::strerror(errno));
+  if (pid == 0) {
+    if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) != 0) {
+      std::perror("ptrace");
+      _exit(127);
+    }
+    execvp(program[0], program);
+    std::fprintf(stderr, "Could not run %s: %s\n", program[0],
+                 std::strerror(errno));
+    _exit(127);
+  }
+
+  // the program stops at its first instruction once exec is done
+  int status;
+  if (waitpid(pid, &status, 0) != pid || !WIFSTOPPED(status)) {
+    fatal("Could not start %s\n", program[0]);
+  }
+  ptrace(PTRACE_SETOPTIONS, pid, NULL, (void *)(long)PTRACE_O_EXITKILL);
+
+  Tracer tracer(pid, writer);
+  status = tracer.run(limit);
+  writer.close();
+
+  std::printf("instructions : %llu\n",
+              (unsigned long long)tracer.instructions);
+  std::printf("branches : %llu\n", (unsigned long long)writer.records());
+  for (int kind = BranchCond; kind <= BranchIndirect; kind++) {
+    std::printf("%s : %llu\n", branchKindName((BranchKind)kind),
+                (unsigned long long)tracer.counts[kind]);
+  }
+  if (status == -1) {
+    std::printf("exit : stopped\n");
+    return 0;
+  }
+  if (WIFSIGNALED(status)) {
+    std::printf("exit : signal %d\n", WTERMSIG(status));
+    return 1;
+  }
+  std::printf("exit : %d\n", WEXITSTATUS(status));
+  return WEXITSTATUS(status) == 0 ? 0 : 1;
+}
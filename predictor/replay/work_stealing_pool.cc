@@ -0,0 +1,109 @@
+/*****************************************************************
+ * File: work_stealing_pool.cc
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Fixed-size thread pool with one task queue per worker
+ * and work stealing between them.
+ ****************************************************************/
+
+#include "work_stealing_pool.hh"
+
+WorkStealingPool::WorkStealingPool(unsigned threads)
+  : nextWorker(0), unclaimed(0), pending(0), stopping(false)
+{
+  if (threads == 0) threads = 1;
+  for (unsigned i = 0; i < threads; i++) {
+    workers.emplace_back(new Worker);
+  }
+  for (unsigned i = 0; i < threads; i++) {
+    this->threads.emplace_back(&WorkStealingPool::run, this, i);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  wait();
+  {
+    std::lock_guard<std::mutex> guard(stateLock);
+    stopping = true;
+  }
+  workReady.notify_all();
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+}
+
+void
+WorkStealingPool::submit(Task task)
+{
+  Worker &worker = *workers[nextWorker];
+  nextWorker = (nextWorker + 1) % workers.size();
+  {
+    std::lock_guard<std::mutex> guard(worker.lock);
+    worker.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> guard(stateLock);
+    unclaimed++;
+    pending++;
+  }
+  workReady.notify_one();
+}
+
+void
+WorkStealingPool::wait()
+{
+  std::unique_lock<std::mutex> guard(stateLock);
+  allDone.wait(guard, [this] { return pending == 0; });
+}
+
+bool
+WorkStealingPool::take(unsigned self, Task &task)
+{
+  // own queue first, most recent task first
+  {
+    Worker &worker = *workers[self];
+    std::lock_guard<std::mutex> guard(worker.lock);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // then steal the oldest task of the next worker that has any
+  for (size_t i = 1; i < workers.size(); i++) {
+    Worker &victim = *workers[(self + i) % workers.size()];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+WorkStealingPool::run(unsigned self)
+{
+  for (;;) {
+    // claim a task before looking for it, so that a queued task is
+    // guaranteed to be left for every claim
+    {
+      std::unique_lock<std::mutex> guard(stateLock);
+      workReady.wait(guard, [this] { return unclaimed > 0 || stopping; });
+      if (unclaimed == 0) return;
+      unclaimed--;
+    }
+
+    // tasks are queued before they are counted, so every claim has a
+    // task left in some queue
+    Task task;
+    while (!take(self, task)) std::this_thread::yield();
+    task();
+
+    std::lock_guard<std::mutex> guard(stateLock);
+    if (--pending == 0) allDone.notify_all();
+  }
+}
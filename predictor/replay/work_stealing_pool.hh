@@ -0,0 +1,94 @@
+/*****************************************************************
+ * File: work_stealing_pool.hh
+ * Created on: 17-Oct-2026
+ * Author: Yash Patel
+ * Description: Fixed-size thread pool with one task queue per worker
+ * and work stealing between them: header file.
+ ****************************************************************/
+
+#ifndef __REPLAY_WORK_STEALING_POOL_HH__
+#define __REPLAY_WORK_STEALING_POOL_HH__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Runs tasks on a fixed number of worker threads. Every worker has its
+ * own queue, which tasks are dealt onto round-robin; a worker takes its
+ * most recent task first and, once its queue is empty, steals the
+ * oldest task of another worker, so that a few long tasks (e.g. replays
+ * with long histories) do not leave the other workers idle.
+ */
+class WorkStealingPool
+{
+public:
+  typedef std::function<void()> Task;
+
+  /**
+   * Starts the workers.
+   * @param threads Number of worker threads, at least 1
+   */
+  explicit WorkStealingPool(unsigned threads);
+
+  /** Waits for the queued tasks and stops the workers */
+  ~WorkStealingPool();
+
+  /** Queues a task, to be run by any worker */
+  void submit(Task task);
+
+  /** Blocks until every task submitted so far has run */
+  void wait();
+
+  /** Number of worker threads */
+  unsigned size() const { return workers.size(); }
+
+private:
+  WorkStealingPool(const WorkStealingPool &);
+  WorkStealingPool &operator=(const WorkStealingPool &);
+
+  /** Task queue of one worker */
+  struct Worker {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  /** Main loop of worker self */
+  void run(unsigned self);
+
+  /**
+   * Takes a task out of the queue of worker self, or else out of
+   * another worker's.
+   * @return Whether a task was found
+   */
+  bool take(unsigned self, Task &task);
+
+  std::vector<std::unique_ptr<Worker> > workers;
+  std::vector<std::thread> threads;
+
+  /** Worker the next submitted task is queued on */
+  unsigned nextWorker;
+
+  /** Protects the counts below and stopping */
+  std::mutex stateLock;
+
+  /** Signalled when tasks are queued or the pool stops */
+  std::condition_variable workReady;
+
+  /** Signalled when the last pending task has run */
+  std::condition_variable allDone;
+
+  /** Queued tasks not yet claimed by a worker */
+  size_t unclaimed;
+
+  /** Submitted tasks that have not finished running */
+  size_t pending;
+
+  bool stopping;
+};
+
+#endif
@@ -15,7 +15,9 @@ BP_NAMES = [
     "LTAGE",        # often best-performing current mainstream predictor
     "AlwaysBP",     # always true branch predictor (static)
     "NeuroBP",      # single perceptron neural branch predictor
-    "NeuroPathBP"   # neural path branch predictor
+    "NeuroPathBP",  # neural path branch predictor
+    "HashedPerceptronBP", # hashed multi-table perceptron predictor
+    "PiecewiseLinearBP"   # piecewise-linear neural path predictor
 ]
 
 EXEC_NAMES = [